@@ -2,6 +2,10 @@
 
 import sys
 import os
+import json
+import time
+import resource
+import contextlib
 import subprocess as sp
 import argparse
 from oracle_utils import *
@@ -11,6 +15,7 @@ parser.add_argument('--opt', dest='opt', action='store', default="2")
 parser.add_argument('--search', dest='needle', action='store', default=None)
 parser.add_argument('--sanitizer', dest='sanitizer', action='store', default="address")
 parser.add_argument('--fitness', dest='fitness', action='store_true', default=False)
+parser.add_argument('--cost-weight', dest='cost_weight', action='store', type=float, default=0.0)
 args = parser.parse_args(sys.argv[2:-1])
 
 # The optimization level to use.
@@ -20,12 +25,58 @@ needle = args.needle
 sanitizer = args.sanitizer
 # Whether to use the fitness score.
 use_scoring = args.fitness or not (needle is None)
+# Score penalty per CPU second spent on evaluating a program. This makes the
+# fuzzer keep programs in its queue that are cheap to evaluate.
+cost_weight = args.cost_weight
 
 compiler = sys.argv[1]
 source_file = sys.argv[-1]
 
-def score(msg, score):
+# If set, every evaluation appends a single-line JSON record describing its
+# outcome to this file. The fuzzer uses this for its stats file.
+oracle_log = os.environ.get("LOOKUB_ORACLE_LOG")
+
+# When the evaluation started.
+start_time = time.monotonic()
+# Wall time (in seconds) spent in each phase of the evaluation, e.g.
+# "[address] -O0". Each phase compiles and runs the program.
+phase_times = {}
+
+@contextlib.contextmanager
+def timedPhase(name):
+    begin = time.monotonic()
+    try:
+        yield
+    finally:
+        phase_times[name] = phase_times.get(name, 0) + time.monotonic() - begin
+
+# Returns the CPU time (in seconds) of all finished child processes, which
+# includes the compilers and the test binaries.
+def childCPUTime():
+    usage = resource.getrusage(resource.RUSAGE_CHILDREN)
+    return usage.ru_utime + usage.ru_stime
+
+# Returns the peak resident set size (in KiB) of the largest finished child.
+def childMaxRSS():
+    return resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+
+def logOutcome(outcome, reason):
+    if not oracle_log:
+        return
+    record = {"outcome": outcome, "reason": reason,
+              "wall_s": round(time.monotonic() - start_time, 4),
+              "cpu_s": round(childCPUTime(), 4),
+              "max_rss_kib": childMaxRSS(),
+              "phases": {k: round(v, 4) for k, v in phase_times.items()}}
+    with open(oracle_log, "a") as f:
+        f.write(json.dumps(record) + "\n")
+
+# Rejects the program. 'reason' is a short, fixed category for the stats
+# file while 'msg' is the detailed message shown to the user.
+def score(reason, msg, score):
+    logOutcome("rejected", reason)
     actual_score = score if use_scoring else 0
+    actual_score -= int(cost_weight * childCPUTime())
     giveScore(msg, actual_score)
 
 
@@ -33,7 +84,7 @@ def score(msg, score):
 # that are this large, but if they are then avoid that we take down
 # the host system by consuming too much memory.
 if os.path.getsize(source_file) > 10000:
-    score("too large source", -30000000)
+    score("too_large", "too large source", -30000000)
 
 # A set of flags passed to all instances.
 base_flags = ["-g", "-w"]
@@ -51,7 +102,7 @@ if is_clang:
     sanitizers += ["memory"]
 
 if not sanitizer in sanitizers:
-    score("Unknown sanitizer: " + sanitizer, -1000)
+    score("unknown_sanitizer", "Unknown sanitizer: " + sanitizer, -1000)
 sanitizers.remove(sanitizer)
 sanitizers = [sanitizer] + sanitizers
 
@@ -77,11 +128,12 @@ def isSanitizerError(stderr):
     # Stack overflows just disappear on optimization and are always
     # false positives.
     if ': stack-overflow ' in stderr:
-        score(prefix + "Ignoring stack-verflow: " + stderr, -80)
+        score("stack_overflow", prefix + "Ignoring stack-verflow: " + stderr, -80)
 
     # We hit an error where the sanitizer complains an allocation is too large.
     if 'maximum supported size' in stderr:
-        score(prefix + "Ignoring too large allocation err: " + stderr, -80)
+        score("too_large_allocation",
+              prefix + "Ignoring too large allocation err: " + stderr, -80)
 
     # GCC's UBSan doesn't print anything on segfaults.
     if is_gcc and len(stderr) == 0:
@@ -109,17 +161,20 @@ def isSanitizerError(stderr):
 # GCC has no memory sanitizer, so an uninitialized use renders the program
 # useless for our testing purposes.
 if is_gcc:
-    binary = compile(compiler, source_file, base_flags)
+    with timedPhase("compile"):
+        binary = compile(compiler, source_file, base_flags)
 
     try:
-        res = sp.run(["valgrind", "--error-exitcode=1", binary],
-                     check=True, timeout=5, capture_output=True)
+        with timedPhase("valgrind"):
+            res = sp.run(["valgrind", "--error-exitcode=1", binary],
+                         check=True, timeout=5, capture_output=True)
     except sp.TimeoutExpired as e:
-        score("Timed out under valgrind", -80)
+        score("valgrind_timeout", "Timed out under valgrind", -80)
     except sp.CalledProcessError as e:
         if "uninitialised" in e.stderr.decode("utf-8"):
             # GCC has no MSan, so skip if we find an uninitialized use.
-            score("Program depends on uninitialized value.", -80)
+            score("uninitialized_value",
+                  "Program depends on uninitialized value.", -80)
         # Otherwise we can search for sanitizer-eliding optimizations.
         pass
 
@@ -136,20 +191,22 @@ for sanitizer in sanitizers:
     # First try without optimization.
     try:
         # First make sure the program has an sanitizer on O0.
-        compileAndRun(compiler, source_file, flags)
+        with timedPhase(prefix + "-O0"):
+            compileAndRun(compiler, source_file, flags)
         print(" No error on -O0")
     except FailedToCompile as e:
         # Just ignore programs if they somehow fail to compile.
-        score(prefix + "Test program failed to compile: " + e.stderr.decode("utf-8"), -80)
+        score("compile_failure",
+              prefix + "Test program failed to compile: " + e.stderr.decode("utf-8"), -80)
     except TimeOutRunning as e:
         # If we timed out compiling then ignore the program.
-        score(prefix + "Test program timed out", -80)
+        score("timeout", prefix + "Test program timed out", -80)
     except FailedToRun as e:
         stderr = e.stderr.decode("utf-8")
         # If we have a needle to look for on O0, check first and then abort if
         # it's not there.
         if needle and not (needle in stderr):
-            score("Can't find search string in output", -1)
+            score("search_miss", "Can't find search string in output", -1)
         # On error, filter out false positives.
         if isSanitizerError(e.stderr.decode("utf-8")):
             had_error = True
@@ -160,14 +217,16 @@ for sanitizer in sanitizers:
     # Try running with optimizations.
     sys.stdout.write("  " + opt_level + ": ")
     try:
-        compileAndRun(compiler, source_file, flags + [opt_level])
+        with timedPhase(prefix + opt_level):
+            compileAndRun(compiler, source_file, flags + [opt_level])
         print(" No error on " + opt_level)
     except FailedToCompile as e:
         # This really should never happen, but e.g., ICE's can cause this.
-        score(prefix + "Optimized program failed to compile???", -80)
+        score("opt_compile_failure",
+              prefix + "Optimized program failed to compile???", -80)
     except TimeOutRunning as e:
         # Ignore timeouts which are usually non-deterministic.
-        score(prefix + "Failed to compile optimized program", -80)
+        score("opt_timeout", prefix + "Failed to compile optimized program", -80)
     except FailedToRun as e:
         internal_crash = False
         # There is an optional check in libc that reports double free's.
@@ -181,12 +240,14 @@ for sanitizer in sanitizers:
         # Abort to save time. This can't be an SEO.
         if not internal_crash:
             print("stderr:" + e.stderr.decode("utf-8"))
-            score(prefix + "Failure still found after optimization", -80)
+            score("still_found_after_opt",
+                  prefix + "Failure still found after optimization", -80)
 
 # If we didn't find any errors on O0 then we failed to make a buggy program.
 if not had_error:
-    score("Program had no sanitizer error on O0", 0)
+    score("no_error_on_O0", "Program had no sanitizer error on O0", 0)
 
 # We had an error on O0 and no iteration of the loop above never aborted
 # this script, so there is no error on any O2 binary.
+logOutcome("finding", "error_gone")
 markInteresting("Error is gone " + extra_info)
@@ -0,0 +1,100 @@
+#include "OracleLog.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+OracleLog::OracleLog(std::string path) : path(path) {
+  // Start with an empty log so that records of previous runs are ignored.
+  std::ofstream(path, std::ios::trunc);
+  setenv(envVar, path.c_str(), /*overwrite=*/1);
+}
+
+std::vector<OracleLog::Record> OracleLog::readNew() {
+  std::vector<Record> result;
+  std::ifstream in(path);
+  if (!in)
+    return result;
+  in.seekg(static_cast<std::streamoff>(offset));
+
+  std::string line;
+  // Only consume complete lines. A partial line is still being written.
+  while (std::getline(in, line) && !in.eof()) {
+    offset += line.size() + 1;
+    Record r;
+    r.outcome = getField(line, "outcome");
+    r.reason = getField(line, "reason");
+    r.wallSeconds = getNumber(line, "wall_s");
+    r.cpuSeconds = getNumber(line, "cpu_s");
+    r.maxRSSKiB = static_cast<uint64_t>(getNumber(line, "max_rss_kib"));
+    r.phaseSeconds = getPhases(line);
+    result.push_back(r);
+  }
+
+  if (offset > truncateAfter) {
+    std::error_code ec;
+    std::filesystem::resize_file(path, 0, ec);
+    if (!ec)
+      offset = 0;
+  }
+  return result;
+}
+
+std::string OracleLog::getField(const std::string &line,
+                                const std::string &key) {
+  const std::string needle = "\"" + key + "\": ";
+  size_t pos = line.find(needle);
+  if (pos == std::string::npos)
+    return "";
+  pos += needle.size();
+  // Unquoted values (numbers) end at the next separator.
+  if (line[pos] != '"') {
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+  }
+  return readString(line, pos);
+}
+
+std::map<std::string, double> OracleLog::getPhases(const std::string &line) {
+  std::map<std::string, double> result;
+  const std::string needle = "\"phases\": {";
+  size_t pos = line.find(needle);
+  if (pos == std::string::npos)
+    return result;
+  pos += needle.size();
+  // The entries are written by json.dumps as '"name": seconds, ...'.
+  while (pos < line.size() && line[pos] == '"') {
+    std::string name = readString(line, pos);
+    if (line.compare(pos, 2, ": ") != 0)
+      break;
+    pos += 2;
+    char *end = nullptr;
+    const double seconds = std::strtod(line.c_str() + pos, &end);
+    if (end == line.c_str() + pos)
+      break;
+    result[name] = seconds;
+    pos = static_cast<size_t>(end - line.c_str());
+    if (line.compare(pos, 2, ", ") == 0)
+      pos += 2;
+  }
+  return result;
+}
+
+std::string OracleLog::readString(const std::string &line, size_t &pos) {
+  std::string res;
+  for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+    if (line[pos] == '\\' && pos + 1 < line.size())
+      ++pos;
+    res += line[pos];
+  }
+  // Skip the closing quote.
+  ++pos;
+  return res;
+}
+
+double OracleLog::getNumber(const std::string &line, const std::string &key) {
+  const std::string value = getField(line, key);
+  if (value.empty())
+    return 0;
+  return std::strtod(value.c_str(), nullptr);
+}
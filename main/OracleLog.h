@@ -0,0 +1,62 @@
+#ifndef ORACLELOG_H
+#define ORACLELOG_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Reads the per-evaluation records that the oracle appends to its log file.
+///
+/// Oracle.py writes one JSON object per line to the file named by the
+/// `LOOKUB_ORACLE_LOG` environment variable. Each record describes how the
+/// evaluation of one program ended.
+class OracleLog {
+public:
+  /// The environment variable that tells the oracle where to log.
+  static constexpr const char *envVar = "LOOKUB_ORACLE_LOG";
+
+  /// A single evaluation of a program by the oracle.
+  struct Record {
+    /// Either "finding" or "rejected".
+    std::string outcome;
+    /// The category of the reason why the evaluation ended.
+    std::string reason;
+    /// The wall time of the evaluation (in seconds).
+    double wallSeconds = 0;
+    /// The CPU time used by the compilers and test binaries (in seconds).
+    double cpuSeconds = 0;
+    /// The peak memory usage of the largest compiler or test process.
+    uint64_t maxRSSKiB = 0;
+    /// The wall time of each phase of the evaluation (in seconds) by the
+    /// phase name, e.g. "compile" or "[address] -O0".
+    std::map<std::string, double> phaseSeconds;
+  };
+
+  /// Creates an empty log at the given path and exports its location to the
+  /// oracle processes started by this process.
+  explicit OracleLog(std::string path);
+
+  /// Returns all records that were appended since the last call.
+  std::vector<Record> readNew();
+
+private:
+  /// Returns the string value of the given key in a single-line JSON object.
+  static std::string getField(const std::string &line, const std::string &key);
+  /// Returns the numeric value of the given key in a single-line JSON object.
+  static double getNumber(const std::string &line, const std::string &key);
+  /// Returns the entries of the "phases" object in a single-line JSON object.
+  static std::map<std::string, double> getPhases(const std::string &line);
+  /// Reads the JSON string starting at 'pos' (the opening quote) and moves
+  /// 'pos' behind the closing quote.
+  static std::string readString(const std::string &line, size_t &pos);
+
+  std::string path;
+  /// How many bytes of the log have already been consumed.
+  uint64_t offset = 0;
+  /// The log is truncated once all records are consumed and it grew past this
+  /// size. This keeps long campaigns from filling up the disk.
+  static constexpr uint64_t truncateAfter = 1U << 20U;
+};
+
+#endif // ORACLELOG_H
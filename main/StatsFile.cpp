@@ -0,0 +1,234 @@
+#include "StatsFile.h"
+#include "LookUB/mutator/AllocStats.h"
+#include "LookUB/mutator/MutatorStats.h"
+
+#include <algorithm>
+#include <ctime>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/// Returns the given string as a quoted JSON string.
+static std::string quote(const std::string &s) {
+  std::string res = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\')
+      res += '\\';
+    if (static_cast<unsigned char>(c) < 0x20)
+      continue;
+    res += c;
+  }
+  return res + "\"";
+}
+
+/// Returns a JSON object with the given counters.
+static std::string
+countersToJSON(const std::map<std::string, uint64_t> &counters) {
+  std::string res = "{";
+  for (const auto &entry : counters) {
+    if (res.size() > 1)
+      res += ", ";
+    res += quote(entry.first) + ": " + std::to_string(entry.second);
+  }
+  return res + "}";
+}
+
+/// Returns the p-th percentile of the given (unsorted) values.
+static double percentile(std::vector<double> values, double p) {
+  if (values.empty())
+    return 0;
+  size_t index = static_cast<size_t>(p * (values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+/// Returns the current resident set size of this process in KiB.
+static uint64_t getCurrentRSSKiB() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident))
+    return 0;
+  return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024U;
+}
+
+/// Returns the resource usage of this process or its finished children.
+static rusage getUsage(int who) {
+  rusage usage = {};
+  getrusage(who, &usage);
+  return usage;
+}
+
+/// Returns the user and system time in the given usage in seconds.
+static double getCPUSeconds(const rusage &usage) {
+  auto toSeconds = [](const timeval &t) { return t.tv_sec + t.tv_usec / 1e6; };
+  return toSeconds(usage.ru_utime) + toSeconds(usage.ru_stime);
+}
+
+StatsFile::StatsFile(std::string path, std::string saveDir, size_t queueSize)
+    : path(path), saveDir(saveDir), queueSize(queueSize),
+      oracleLog(path + ".oracle-log") {}
+
+void StatsFile::step(const std::function<void()> &stepFunc) {
+  const MutatorStats &mutStats = MutatorStats::get();
+  const auto mutationTimeBefore = mutStats.getMutationTime();
+  const Clock::time_point start = Clock::now();
+
+  stepFunc();
+
+  // Everything in the step that is not mutating is spent on the oracle.
+  const Clock::duration stepTime = Clock::now() - start;
+  const Clock::duration oracleTime =
+      stepTime - (mutStats.getMutationTime() - mutationTimeBefore);
+  const double latencyMs =
+      std::chrono::duration<double, std::milli>(oracleTime).count();
+  if (latencies.size() < maxLatencies)
+    latencies.push_back(latencyMs);
+  else
+    latencies[nextLatency] = latencyMs;
+  nextLatency = (nextLatency + 1) % maxLatencies;
+  ++programs;
+
+  for (const OracleLog::Record &r : oracleLog.readNew()) {
+    const bool isFinding = r.outcome == "finding";
+    if (isFinding)
+      ++findings;
+    else
+      ++rejections[r.reason];
+    totalCost.add(r);
+    costByReason[r.reason].add(r);
+    costByStrategy[MutatorStats::get().getLastStrategy()].add(r);
+    MutatorStats::get().recordOutcome(isFinding, r.reason, r.cpuSeconds);
+  }
+
+  if (Clock::now() - lastWrite >= updateInterval)
+    write();
+}
+
+size_t StatsFile::countFindings() const {
+  std::error_code ec;
+  size_t result = 0;
+  for (const auto &entry : std::filesystem::directory_iterator(saveDir, ec))
+    if (entry.is_regular_file(ec))
+      ++result;
+  return result;
+}
+
+bool StatsFile::write() {
+  const Clock::time_point now = Clock::now();
+  const double uptime =
+      std::chrono::duration<double>(now - startTime).count();
+  const double sinceLastWrite =
+      std::chrono::duration<double>(now - lastWrite).count();
+  const double programsPerSec = uptime > 0 ? programs / uptime : 0;
+  const double recentPerSec =
+      sinceLastWrite > 0 ? (programs - programsAtLastWrite) / sinceLastWrite
+                         : 0;
+  lastWrite = now;
+  programsAtLastWrite = programs;
+
+  const MutatorStats &mutStats = MutatorStats::get();
+
+  std::stringstream out;
+  out << "{\n";
+  out << "  \"unix_time\": " << std::time(nullptr) << ",\n";
+  out << "  \"uptime_s\": " << uptime << ",\n";
+  out << "  \"programs\": " << programs << ",\n";
+  out << "  \"programs_per_sec\": " << programsPerSec << ",\n";
+  out << "  \"programs_per_sec_recent\": " << recentPerSec << ",\n";
+  out << "  \"oracle_latency_ms\": {\"p50\": " << percentile(latencies, 0.5)
+      << ", \"p90\": " << percentile(latencies, 0.9)
+      << ", \"p99\": " << percentile(latencies, 0.99)
+      << ", \"max\": " << percentile(latencies, 1) << "},\n";
+  out << "  \"mutation_time_s\": "
+      << std::chrono::duration<double>(mutStats.getMutationTime()).count()
+      << ",\n";
+  out << "  \"queue_max_size\": " << queueSize << ",\n";
+  out << "  \"rss_kib\": " << getCurrentRSSKiB() << ",\n";
+  out << "  \"peak_rss_kib\": " << getUsage(RUSAGE_SELF).ru_maxrss << ",\n";
+  // The oracle processes are children of this process, so this is their
+  // rusage as reported by wait4.
+  const rusage children = getUsage(RUSAGE_CHILDREN);
+  out << "  \"children_cpu_s\": " << getCPUSeconds(children) << ",\n";
+  out << "  \"children_max_rss_kib\": " << children.ru_maxrss << ",\n";
+  out << "  \"findings\": " << findings << ",\n";
+  out << "  \"saved_testcases\": " << countFindings() << ",\n";
+  out << "  \"findings_per_cpu_hour\": " << totalCost.getFindingsPerCPUHour()
+      << ",\n";
+  out << "  \"rejections\": " << countersToJSON(rejections) << ",\n";
+  out << "  \"oracle_cost_by_reason\": " << costsToJSON(costByReason)
+      << ",\n";
+  out << "  \"oracle_cost_by_strategy\": " << costsToJSON(costByStrategy)
+      << ",\n";
+  out << "  \"flat_body_cache\": {\"hits\": " << mutStats.getFlatBodyHits()
+      << ", \"misses\": " << mutStats.getFlatBodyMisses() << "},\n";
+  out << "  \"type_gc\": {\"runs\": " << mutStats.getTypeCollections()
+      << ", \"skipped\": " << mutStats.getSkippedTypeCollections() << "},\n";
+  out << "  \"strategy_mix\": " << countersToJSON(mutStats.getStrategyMix());
+  if (AllocStats::isEnabled()) {
+    out << ",\n  \"allocations\": {";
+    for (size_t i = 0; i < static_cast<size_t>(AllocPhase::NumPhases); ++i) {
+      const AllocPhase phase = static_cast<AllocPhase>(i);
+      const AllocStats::Counter c = AllocStats::get(phase);
+      out << (i ? ", " : "") << quote(AllocStats::getPhaseName(phase))
+          << ": {\"count\": " << c.allocations << ", \"bytes\": " << c.bytes
+          << "}";
+    }
+    out << "}";
+  }
+  out << "\n";
+  out << "}\n";
+
+  bool success = writeAtomically(path, out.str());
+
+  if (!decisionReportPath.empty()) {
+    std::stringstream report;
+    mutStats.printDecisionReport(report);
+    success &= writeAtomically(decisionReportPath, report.str());
+  }
+  return success;
+}
+
+std::string
+StatsFile::costsToJSON(const std::map<std::string, OracleCost> &costs) {
+  std::stringstream res;
+  res << "{";
+  bool first = true;
+  for (const auto &entry : costs) {
+    if (!first)
+      res << ", ";
+    first = false;
+    const OracleCost &cost = entry.second;
+    res << quote(entry.first) << ": {\"programs\": " << cost.programs
+        << ", \"findings\": " << cost.findings
+        << ", \"wall_s\": " << cost.wallSeconds
+        << ", \"cpu_s\": " << cost.cpuSeconds
+        << ", \"max_rss_kib\": " << cost.maxRSSKiB
+        << ", \"findings_per_cpu_hour\": " << cost.getFindingsPerCPUHour()
+        << ", \"phases_wall_s\": {";
+    bool firstPhase = true;
+    for (const auto &phase : cost.phaseSeconds) {
+      if (!firstPhase)
+        res << ", ";
+      firstPhase = false;
+      res << quote(phase.first) << ": " << phase.second;
+    }
+    res << "}}";
+  }
+  res << "}";
+  return res.str();
+}
+
+bool StatsFile::writeAtomically(const std::string &path,
+                                const std::string &contents) {
+  const std::string tmpPath = path + ".tmp";
+  {
+    std::ofstream tmp(tmpPath, std::ios::trunc);
+    tmp << contents;
+    if (!tmp.flush())
+      return false;
+  }
+  return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
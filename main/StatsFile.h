@@ -0,0 +1,117 @@
+#ifndef STATSFILE_H
+#define STATSFILE_H
+
+#include "OracleLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/// Periodically writes machine-readable fuzzing statistics to a file.
+///
+/// The file is a single JSON object that is replaced atomically, so external
+/// monitoring can read it at any time without seeing partial updates.
+class StatsFile {
+public:
+  typedef std::chrono::steady_clock Clock;
+
+  /// @param path Where the stats file should be written.
+  /// @param saveDir The directory where findings are stored.
+  /// @param queueSize The maximum size of the scheduler queue.
+  StatsFile(std::string path, std::string saveDir, size_t queueSize);
+
+  /// Sets how often the stats file is rewritten (in ms).
+  void setUpdateInterval(unsigned ms) {
+    updateInterval = std::chrono::milliseconds(ms);
+  }
+
+  /// Sets where the per-decision cost/yield report should be written.
+  void setDecisionReportPath(std::string path) { decisionReportPath = path; }
+
+  /// Runs a single scheduler step and records how long it took.
+  void step(const std::function<void()> &stepFunc);
+
+  /// Writes the current stats to disk.
+  /// @return False if the file could not be written.
+  bool write();
+
+private:
+  /// Counts the findings in the save directory.
+  size_t countFindings() const;
+
+  /// Replaces the file at the given path with the given contents.
+  ///
+  /// The contents are written to a temporary file first and then renamed
+  /// over the old file. The rename is atomic, so readers never see a
+  /// partially written file.
+  static bool writeAtomically(const std::string &path,
+                              const std::string &contents);
+
+  std::string path;
+  std::string decisionReportPath;
+  std::string saveDir;
+  size_t queueSize;
+  Clock::duration updateInterval = std::chrono::seconds(5);
+
+  /// Records written by the oracle.
+  OracleLog oracleLog;
+
+  Clock::time_point startTime = Clock::now();
+  Clock::time_point lastWrite = Clock::now();
+  /// Total number of evaluated programs.
+  uint64_t programs = 0;
+  /// Number of evaluated programs at the time of the last write.
+  uint64_t programsAtLastWrite = 0;
+
+  /// The oracle latency (in ms) of the most recent programs.
+  std::vector<double> latencies;
+  /// The next slot in 'latencies' to overwrite.
+  size_t nextLatency = 0;
+  /// How many latency samples are kept for the percentiles.
+  static constexpr size_t maxLatencies = 4096;
+
+  /// The resources the oracle spent on some group of programs.
+  struct OracleCost {
+    uint64_t programs = 0;
+    uint64_t findings = 0;
+    double wallSeconds = 0;
+    double cpuSeconds = 0;
+    uint64_t maxRSSKiB = 0;
+    /// The wall time spent in each phase of the oracle (in seconds).
+    std::map<std::string, double> phaseSeconds;
+    void add(const OracleLog::Record &r) {
+      ++programs;
+      if (r.outcome == "finding")
+        ++findings;
+      wallSeconds += r.wallSeconds;
+      cpuSeconds += r.cpuSeconds;
+      maxRSSKiB = std::max(maxRSSKiB, r.maxRSSKiB);
+      for (const auto &phase : r.phaseSeconds)
+        phaseSeconds[phase.first] += phase.second;
+    }
+    /// The metric we care about in the end.
+    double getFindingsPerCPUHour() const {
+      return cpuSeconds > 0 ? findings / (cpuSeconds / 3600) : 0;
+    }
+  };
+  /// Returns a JSON object with the given costs.
+  static std::string
+  costsToJSON(const std::map<std::string, OracleCost> &costs);
+
+  /// Oracle costs of all evaluated programs.
+  OracleCost totalCost;
+  /// Oracle costs by the reason that ended the evaluation.
+  std::map<std::string, OracleCost> costByReason;
+  /// Oracle costs by the strategy that mutated the evaluated program.
+  std::map<std::string, OracleCost> costByStrategy;
+
+  /// Number of findings reported by the oracle.
+  uint64_t findings = 0;
+  /// Rejected programs by the reason the oracle gave.
+  std::map<std::string, uint64_t> rejections;
+};
+
+#endif // STATSFILE_H
@@ -1,4 +1,6 @@
 #include "LookUB/mutator/UnsafeGenerator.h"
+#include "LookUB/mutator/Verification.h"
+#include "StatsFile.h"
 #include "scc/driver/ArgParser.h"
 #include "scc/driver/Driver.h"
 #include "scc/driver/DriverUtils.h"
@@ -6,6 +8,10 @@
 
 #include <filesystem>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 
 static void printUsage(std::string progamName) {
   std::cerr << "Usage: " << progamName
@@ -22,6 +28,42 @@ static void printUsage(std::string progamName) {
   std::cerr << " --reducer-tries=N How many tries to reduce programs. \n";
   std::cerr << " --ui-update=N     UI update frequency (in ms)\n";
   std::cerr << " --splash          Whether to show a startup splash.\n";
+  std::cerr << " --stats-file=PATH Periodically write machine-readable stats.\n";
+  std::cerr << " --stats-interval=N Stats file update interval (in ms).\n";
+  std::cerr << " --decision-report=PATH Periodically write the cost and yield"
+               " of every mutator decision.\n";
+  std::cerr << " --verify=LEVEL    How much generated code is verified "
+               "(off/sampled/changed/full).\n";
+}
+
+/// Removes the option '--name=value' from the given arguments.
+/// @return The value of the option or none if it was not passed.
+static std::optional<std::string> takeOption(std::vector<std::string> &args,
+                                             const std::string &name) {
+  const std::string prefix = "--" + name + "=";
+  for (auto it = args.begin(); it != args.end(); ++it) {
+    if (it->rfind(prefix, 0) != 0)
+      continue;
+    std::string value = it->substr(prefix.size());
+    args.erase(it);
+    return value;
+  }
+  return {};
+}
+
+/// Parses a non-negative decimal number.
+/// @return The number or none if the string isn't a valid unsigned number.
+static std::optional<unsigned> parseUnsigned(const std::string &s) {
+  if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+    return {};
+  try {
+    const unsigned long value = std::stoul(s);
+    if (value > std::numeric_limits<unsigned>::max())
+      return {};
+    return static_cast<unsigned>(value);
+  } catch (const std::out_of_range &) {
+    return {};
+  }
 }
 
 template <typename Gen> int generatorMain(const ArgParser &args) {
@@ -42,8 +84,33 @@ template <typename Gen> int generatorMain(const ArgParser &args) {
   sched.setStopAfterHit(args.stopAfterHits);
   sched.setReducerTries(args.reducerTries);
 
+  // Handle the options of the fuzzer binary itself.
+  std::vector<std::string> unknownArgs = args.unknownArgs;
+  std::optional<std::string> statsPath = takeOption(unknownArgs, "stats-file");
+  std::optional<unsigned> statsIntervalMs;
+  if (std::optional<std::string> interval =
+          takeOption(unknownArgs, "stats-interval")) {
+    statsIntervalMs = parseUnsigned(*interval);
+    if (!statsIntervalMs) {
+      printUsage(args.argv0);
+      std::cerr << "Invalid stats interval: " << *interval << "\n";
+      return 1;
+    }
+  }
+  std::optional<std::string> decisionReportPath =
+      takeOption(unknownArgs, "decision-report");
+  if (std::optional<std::string> verify = takeOption(unknownArgs, "verify")) {
+    std::optional<VerifyLevel> level = Verification::parseLevel(*verify);
+    if (!level) {
+      printUsage(args.argv0);
+      std::cerr << "Unknown verification level: " << *verify << "\n";
+      return 1;
+    }
+    Verification::setLevel(*level);
+  }
+
   // Let the scheduler/generator handle unknown args.
-  if (auto err = sched.handleArgs(args.unknownArgs)) {
+  if (auto err = sched.handleArgs(unknownArgs)) {
     printUsage(args.argv0);
     std::cerr << err->getMessage() << "\n";
     return 1;
@@ -61,9 +128,30 @@ template <typename Gen> int generatorMain(const ArgParser &args) {
     return 1;
   }
 
+  // Optionally keep track of stats for external monitoring.
+  std::unique_ptr<StatsFile> stats;
+  if (statsPath || decisionReportPath) {
+    // The decision report needs the oracle outcomes which are collected by
+    // the stats file, so create one next to the report if necessary.
+    std::string path =
+        statsPath ? *statsPath : *decisionReportPath + ".stats.json";
+    stats = std::make_unique<StatsFile>(path, saveDir, args.queueSize);
+    if (statsIntervalMs)
+      stats->setUpdateInterval(*statsIntervalMs);
+    if (decisionReportPath)
+      stats->setDecisionReportPath(*decisionReportPath);
+  }
+
   // Create the driver that runs the scheduler and displays the UI.
   Driver driver(
-      sched, evalCommand, [&sched]() { sched.step(); }, saveDir);
+      sched, evalCommand,
+      [&sched, &stats]() {
+        if (stats)
+          stats->step([&sched]() { sched.step(); });
+        else
+          sched.step();
+      },
+      saveDir);
   driver.setSimpleUI(args.simpleUI);
   driver.setUpdateInterval(args.uiUpdateMs);
   driver.setManualStepping(args.manualStepping);
@@ -74,6 +162,8 @@ template <typename Gen> int generatorMain(const ArgParser &args) {
 
   // Run until we are done.
   driver.run(args.splash);
+  if (stats)
+    stats->write();
   return 0;
 }
 
@@ -0,0 +1,60 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/// Parts of the mutator that heap allocations are attributed to.
+enum class AllocPhase {
+#define ALLOC_PHASE(ID) ID,
+#include "AllocPhases.def"
+  NumPhases
+};
+
+/// Counts heap allocations and attributes them to mutator phases.
+///
+/// Counting is only done if the project is configured with
+/// `-DLOOKUB_ALLOC_STATS=ON`, which replaces the global allocation functions.
+/// In normal builds all of this compiles to nothing.
+class AllocStats {
+public:
+  /// The allocations done in a single phase.
+  struct Counter {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+  };
+
+  /// Returns true if allocation counting was compiled in.
+  static constexpr bool isEnabled() {
+#ifdef LOOKUB_ALLOC_STATS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /// Returns the allocations done so far in the given phase.
+  static Counter get(AllocPhase phase);
+
+  /// Returns the user-readable name of the given phase.
+  static const char *getPhaseName(AllocPhase phase);
+
+  /// Attributes all allocations of the current thread to the given phase
+  /// while this object is alive.
+  class Scope {
+#ifdef LOOKUB_ALLOC_STATS
+    AllocPhase previous;
+
+  public:
+    explicit Scope(AllocPhase phase);
+    ~Scope();
+#else
+  public:
+    explicit Scope(AllocPhase) {}
+#endif
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+  };
+};
+
+#endif // ALLOCSTATS_H
@@ -1,6 +1,7 @@
 #ifndef CANONICALIZER_H
 #define CANONICALIZER_H
 
+#include "AllocStats.h"
 #include "scc/program/Statement.h"
 
 #include <optional>
@@ -15,6 +16,7 @@ public:
   /// Tries to simplify the given code without changing any semantics.
   /// Returns none if the code can't be simplified.
   static std::optional<Statement> canonicalizeStmt(const Statement &s) {
+    AllocStats::Scope allocScope(AllocPhase::Canonicalization);
     auto res = canonicalize(s);
     // TODO: Add some sanity checks here?
     return res;
@@ -0,0 +1,50 @@
+#ifndef DECISIONLOG_H
+#define DECISIONLOG_H
+
+#include "UnsafeStrategy.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Compact record of the decisions taken while mutating a program.
+///
+/// Stores how often each decision was taken in a fixed-size array indexed by
+/// Frag, so recording and attributing decisions doesn't allocate.
+class DecisionLog {
+public:
+  typedef UnsafeStrategy::Frag Frag;
+
+  /// The number of different decisions.
+  static constexpr size_t NumFrags = 0
+#define DECISION(ID) +1
+#include "UnsafeDecisions.def"
+      ;
+
+  /// Records that the given decision was taken.
+  void add(Frag f) { ++counts.at(static_cast<size_t>(f)); }
+  /// Records all given decisions.
+  void add(const std::vector<Frag> &decisions);
+
+  /// Returns how often the given decision was taken.
+  uint32_t getCount(Frag f) const { return counts.at(static_cast<size_t>(f)); }
+  /// Returns true if the given decision was taken at least once.
+  bool contains(Frag f) const { return getCount(f) != 0; }
+  /// Returns true if no decision was taken.
+  bool empty() const;
+  /// Forgets all taken decisions.
+  void clear() { counts.fill(0); }
+
+  /// Calls `func(frag, count)` for every decision that was taken.
+  template <typename F> void forEach(F func) const {
+    for (size_t i = 0; i < NumFrags; ++i)
+      if (counts[i] != 0)
+        func(static_cast<Frag>(i), counts[i]);
+  }
+
+private:
+  std::array<uint32_t, NumFrags> counts = {};
+};
+
+#endif // DECISIONLOG_H
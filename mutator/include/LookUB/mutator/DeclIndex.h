@@ -0,0 +1,50 @@
+#ifndef DECLINDEX_H
+#define DECLINDEX_H
+
+#include "scc/program/Function.h"
+#include "scc/program/GlobalVar.h"
+#include "scc/program/Program.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// Index of the declarations in a program.
+///
+/// Keeps the functions, the global variables (by type) and the main function
+/// of a program so that the mutator doesn't have to walk the whole decl list
+/// to find them. The index is built from the program once and afterwards the
+/// mutator adds/removes every declaration it creates/deletes.
+class DeclIndex {
+public:
+  /// Indexes all declarations in the given program.
+  void build(const Program &p);
+  /// Returns true if the index has been built and is still valid.
+  bool isBuilt() const { return built; }
+  /// Forgets all indexed declarations.
+  void invalidate();
+
+  /// Adds the given declaration. Does nothing if it's already known.
+  void add(const Program &p, Decl *d);
+  /// Removes the given declaration.
+  void remove(Decl *d);
+
+  /// Returns all declarations.
+  const std::vector<Decl *> &getAll() const { return all; }
+  /// Returns all function declarations.
+  const std::vector<Function *> &getFunctions() const { return functions; }
+  /// Returns all global variables with the given type.
+  const std::vector<GlobalVar *> &getGlobalsOfType(TypeRef t) const;
+  /// Returns the main function or a nullptr if there is none.
+  Function *getMain() const { return main; }
+
+private:
+  bool built = false;
+  std::vector<Decl *> all;
+  std::unordered_set<const Decl *> known;
+  std::vector<Function *> functions;
+  std::unordered_map<size_t, std::vector<GlobalVar *>> globalsByType;
+  Function *main = nullptr;
+};
+
+#endif // DECLINDEX_H
@@ -0,0 +1,75 @@
+#ifndef FLATBODY_H
+#define FLATBODY_H
+
+#include "scc/program/Function.h"
+#include "scc/program/Statement.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// A flattened copy of a function body for analyses that only look at
+/// node kinds and IDs.
+///
+/// The nodes are stored in post-order in separate contiguous arrays, so
+/// counting a node kind is a linear pass over a single array instead of
+/// chasing the pointers of the statement tree.
+class FlatBody {
+public:
+  explicit FlatBody(const Statement &body);
+
+  /// Returns the number of nodes in the body.
+  size_t size() const { return kinds.size(); }
+
+  /// Returns the kind of the i-th node.
+  Statement::Kind getKind(size_t i) const { return kinds[i]; }
+  /// Returns the ID of the i-th node. This is the declared/referenced
+  /// variable, the jump target of gotos and labels and the called function.
+  /// Other nodes have an invalid ID.
+  NameID getID(size_t i) const { return ids[i]; }
+
+  /// Returns how many nodes of the given kind are in the body.
+  size_t count(Statement::Kind kind) const {
+    size_t result = 0;
+    for (Statement::Kind k : kinds)
+      result += (k == kind);
+    return result;
+  }
+
+  /// Returns the index of the n-th node (in post-order) of the given kind.
+  /// The body must contain more than 'n' nodes of that kind.
+  size_t findNth(Statement::Kind kind, size_t n) const;
+
+private:
+  /// Appends the subtree of 's' in post-order.
+  void add(const Statement &s);
+
+  std::vector<Statement::Kind> kinds;
+  std::vector<NameID> ids;
+};
+
+/// The flattened bodies of the functions in a program.
+///
+/// Bodies are flattened on first use and have to be invalidated whenever
+/// the body of a function changes.
+class FlatBodyCache {
+public:
+  /// Returns the flattened body of the given function.
+  const FlatBody &get(const Function &f);
+  /// Forgets the flattened body of the given function.
+  void invalidate(const Function *f) { bodies.erase(f); }
+  /// Forgets all flattened bodies. The hit/miss counters are kept.
+  void clear() { bodies.clear(); }
+
+  /// Returns how often a flattened body could be reused.
+  uint64_t getHits() const { return hits; }
+  /// Returns how often a body had to be flattened.
+  uint64_t getMisses() const { return misses; }
+
+private:
+  std::unordered_map<const Function *, FlatBody> bodies;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+#endif // FLATBODY_H
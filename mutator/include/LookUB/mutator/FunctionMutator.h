@@ -1,6 +1,7 @@
 #ifndef FUNCTIONMUTATOR_H
 #define FUNCTIONMUTATOR_H
 
+#include "TokenCatalogue.h"
 #include "UnsafeMutatorBase.h"
 #include <string>
 
@@ -24,18 +25,29 @@ class FunctionMutator : public UnsafeMutatorBase {
 
   /// Returns a random function attribute.
   std::string getRandomFuncAttr() {
-    // Dump of random Clang attributes.
-    return getRng().pickOneVec<std::string>(
-        {"__attribute__((alloc_size(" + uintStr(4) + ")))",
-         "__attribute__((alloc_size(" + uintStr(4) + ", " + uintStr(4) + ")))",
-         "__attribute__((always_inline))",
-         "__attribute__((assume_aligned (" + uintStr(4) + ")))",
-         "__attribute__((const))", "__attribute__((disable_tail_calls))",
-         "__attribute__((flatten))", "__attribute__((malloc))",
-         "__attribute__((no_builtin))", "__attribute__((noinline))",
-         "__attribute__((pure))",
-         "__attribute__((no_caller_saved_registers, " +
-             getRandomCallingConvName() + "))"});
+    const std::vector<std::string> &fixed =
+        TokenCatalogue::get().getFixedFuncAttrs();
+    // Attributes with random parameters.
+    enum { AllocSize, AllocSize2, AssumeAligned, NoCallerSaved, NumParamAttrs };
+
+    // Pick the attribute first so that only the picked one is built.
+    const size_t index = getRng().pickIndex(fixed.size() + NumParamAttrs);
+    if (index < fixed.size())
+      return fixed[index];
+    switch (index - fixed.size()) {
+    case AllocSize:
+      return "__attribute__((alloc_size(" + uintStr(4) + ")))";
+    case AllocSize2:
+      return "__attribute__((alloc_size(" + uintStr(4) + ", " + uintStr(4) +
+             ")))";
+    case AssumeAligned:
+      return "__attribute__((assume_aligned (" + uintStr(4) + ")))";
+    case NoCallerSaved:
+      return "__attribute__((no_caller_saved_registers, " +
+             getRandomCallingConvName() + "))";
+    }
+    SCCError("Missing switch?");
+    return fixed.front();
   }
 
 public:
@@ -43,6 +55,7 @@ public:
 
   /// Randomizes the function attributes of the given function.
   Modified randomizeFuncAttrs(Function &f) {
+    AllocStats::Scope allocScope(AllocPhase::FunctionAttrs);
     if (decision(Frag::UseNonStdCallingConv)) {
       f.setCallingConv(getRandomCallingConv());
       return Modified::Yes;
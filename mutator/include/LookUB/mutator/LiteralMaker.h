@@ -1,6 +1,7 @@
 #ifndef LITERALMAKER_H
 #define LITERALMAKER_H
 
+#include "TokenCatalogue.h"
 #include "UnsafeMutatorBase.h"
 
 /// Creates literal strings for specific types.
@@ -15,19 +16,8 @@ private:
   /// Returns a valid constant string for the given type.
   std::string makeConstantStr(TypeRef tref);
 
-  /// Known 'special' integers.
-  ///
-  /// Mostly powers of two and neighbors.
-  std::vector<std::string> specialIntegers;
-  /// Known 'special' floats.
-  ///
-  /// Mostly powers of two and neighbors.
-  std::vector<std::string> specialFloats;
-
-  /// Sets up the internal integer value list.
-  void setupIntegers();
-  /// Sets up the internal float value list.
-  void setupFloats();
+  /// The shared tables of special literals.
+  const TokenCatalogue &catalogue;
 };
 
 #endif // LITERALMAKER_H
@@ -0,0 +1,129 @@
+#ifndef MUTATORSTATS_H
+#define MUTATORSTATS_H
+
+#include "DecisionLog.h"
+#include "UnsafeStrategy.h"
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Process-wide counters that describe the work done by the mutator.
+///
+/// The counters are only updated from the thread that runs the scheduler, so
+/// they are not synchronized.
+class MutatorStats {
+public:
+  typedef std::chrono::steady_clock Clock;
+  typedef UnsafeStrategy::Frag Frag;
+
+  /// Cost and yield of a single decision in UnsafeDecisions.def.
+  struct DecisionProfile {
+    /// How often the decision was taken.
+    uint64_t fired = 0;
+    /// How many mutate() calls took the decision at least once.
+    uint64_t mutations = 0;
+    /// The time spent in the mutate() calls that took the decision.
+    Clock::duration time = Clock::duration::zero();
+    /// How many of those mutate() calls didn't modify the program.
+    uint64_t unmodified = 0;
+    /// How many of the resulting programs were findings.
+    uint64_t findings = 0;
+    /// How many of the resulting programs were rejected (by reason).
+    std::map<std::string, uint64_t> rejections;
+    /// The CPU time the oracle spent on the resulting programs.
+    double oracleCPUSeconds = 0;
+
+    /// Returns the total number of rejected programs.
+    uint64_t getRejected() const;
+  };
+
+  MutatorStats();
+
+  /// Returns the stats of the current process.
+  static MutatorStats &get();
+
+  /// Records a finished mutate() call.
+  /// @param strategy The name of the used strategy.
+  /// @param decisions The decisions that were taken during the call.
+  /// @param modified Whether the call modified the program.
+  /// @param time The time the call took.
+  void recordMutation(const std::string &strategy,
+                      const std::vector<Frag> &decisions, bool modified,
+                      Clock::duration time);
+
+  /// Records the oracle outcome for the most recently mutated program.
+  /// @param finding True if the program was a finding.
+  /// @param reason Why the program was rejected (if it wasn't a finding).
+  /// @param cpuSeconds The CPU time the oracle spent on the program.
+  void recordOutcome(bool finding, const std::string &reason,
+                     double cpuSeconds = 0);
+
+  /// Records how often flattened function bodies were reused (hits) and
+  /// built (misses) during a mutate() call.
+  void recordFlatBodyCache(uint64_t hits, uint64_t misses) {
+    flatBodyHits += hits;
+    flatBodyMisses += misses;
+  }
+
+  /// Returns how often a flattened function body was reused.
+  uint64_t getFlatBodyHits() const { return flatBodyHits; }
+  /// Returns how often a function body had to be flattened.
+  uint64_t getFlatBodyMisses() const { return flatBodyMisses; }
+
+  /// Records a GarbageCollectTypes decision.
+  /// @param ran False if the collector was skipped because no type could be
+  ///            unused.
+  void recordTypeCollection(bool ran) {
+    if (ran)
+      ++typeCollections;
+    else
+      ++skippedTypeCollections;
+  }
+
+  /// Returns how often the type garbage collector ran.
+  uint64_t getTypeCollections() const { return typeCollections; }
+  /// Returns how often the type garbage collector was skipped.
+  uint64_t getSkippedTypeCollections() const { return skippedTypeCollections; }
+
+  /// Returns how many programs have been mutated so far.
+  uint64_t getMutations() const { return mutations; }
+  /// Returns the total wall time spent in the mutator.
+  Clock::duration getMutationTime() const { return mutationTime; }
+  /// Returns how often each strategy (by name) has been used.
+  const std::map<std::string, uint64_t> &getStrategyMix() const {
+    return strategyMix;
+  }
+  /// Returns the name of the strategy that mutated the last program.
+  const std::string &getLastStrategy() const { return lastStrategy; }
+  /// Returns the profile of the given decision.
+  const DecisionProfile &getProfile(Frag f) const {
+    return decisionProfiles.at(static_cast<size_t>(f));
+  }
+
+  /// Prints a table with the cost and yield of every decision.
+  ///
+  /// The most expensive decisions are listed first.
+  void printDecisionReport(std::ostream &out) const;
+
+private:
+  uint64_t mutations = 0;
+  Clock::duration mutationTime = Clock::duration::zero();
+  std::map<std::string, uint64_t> strategyMix;
+  std::string lastStrategy;
+  uint64_t flatBodyHits = 0;
+  uint64_t flatBodyMisses = 0;
+  uint64_t typeCollections = 0;
+  uint64_t skippedTypeCollections = 0;
+
+  /// Profiles indexed by Frag.
+  std::vector<DecisionProfile> decisionProfiles;
+  /// The decisions taken for the last mutated program. Its oracle outcome is
+  /// attributed to these.
+  DecisionLog lastDecisions;
+};
+
+#endif // MUTATORSTATS_H
@@ -15,10 +15,13 @@ public:
   Snippets(MutatorData &input)
       : UnsafeMutatorBase(input), literals(input), tc(input) {}
 
+  /// Prepares this Snippets instance for another mutation of the program.
+  void reset() { tc.reset(); }
+
   /// Create a random predefined piece of code.
   Statement createSnippet(const StatementContext &s) {
     Statement res = createSnippetImpl(s);
-    p.verifySelf();
+    verifyProgramAfterChange(res);
     return res;
   }
 };
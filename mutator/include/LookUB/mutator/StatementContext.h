@@ -4,20 +4,41 @@
 #include "scc/program/Function.h"
 #include "scc/program/Statement.h"
 #include "scc/program/Variable.h"
-#include <unordered_map>
-#include <vector>
+#include <cstddef>
+#include <memory>
+#include <optional>
 
 /// Provides information that helps with transforming/inspecting a statement.
 ///
 /// The information here  is usually information that is not stored  in the
 /// statement itself (for space/complexity reasons).
+///
+/// Contexts are passed around by value a lot, so the variables in scope are
+/// stored in a persistent list that all copies share. Copying a context and
+/// adding a variable are O(1).
 struct StatementContext {
-  std::unordered_map<NameID, Variable> variables;
-  std::optional<Variable> getVar(NameID id) {
-    auto iter = variables.find(id);
-    if (iter == variables.end())
-      return {};
-    return iter->second;
+  /// Makes the given variable available in this context.
+  void addVariable(const Variable &v) {
+    vars = std::make_shared<const VarNode>(VarNode{v, vars});
+    ++numVars;
+  }
+
+  /// Returns the variable with the given ID if it is in this context.
+  std::optional<Variable> getVar(NameID id) const {
+    for (const VarNode *n = vars.get(); n; n = n->next.get())
+      if (n->var.getName() == id)
+        return n->var;
+    return {};
+  }
+
+  /// Returns the number of variables in this context.
+  size_t getNumVars() const { return numVars; }
+
+  /// Calls 'func' for every variable in this context. The most recently
+  /// added variables are visited first.
+  template <typename F> void forEachVar(F func) const {
+    for (const VarNode *n = vars.get(); n; n = n->next.get())
+      func(n->var);
   }
 
   /// Whether the statement is within a loop.
@@ -32,6 +53,7 @@ struct StatementContext {
   /// returns an empty statement to simplify
   /// usage.
   const Statement &getFuncBody() const {
+    static const Statement fakeBody;
     if (function)
       return function->getBody();
     return fakeBody;
@@ -47,10 +69,8 @@ struct StatementContext {
   /// the context.
   void expandWithStmt(const Statement &s) {
     if (s.getKind() == Statement::Kind::VarDecl ||
-        s.getKind() == Statement::Kind::VarDef) {
-      Variable v(s.getVariableType(), s.getDeclaredVarID());
-      variables[v.getName()] = v;
-    }
+        s.getKind() == Statement::Kind::VarDef)
+      addVariable(Variable(s.getVariableType(), s.getDeclaredVarID()));
   }
 
   /// Returns the StatementContext for a global
@@ -59,6 +79,15 @@ struct StatementContext {
 
 private:
   StatementContext() = default;
-  Statement fakeBody;
+
+  /// A node in the persistent list of variables.
+  struct VarNode {
+    Variable var;
+    std::shared_ptr<const VarNode> next;
+  };
+  /// The most recently added variable.
+  std::shared_ptr<const VarNode> vars;
+  /// The length of the 'vars' list.
+  size_t numVars = 0;
 };
 #endif // STATEMENTCONTEXT_H
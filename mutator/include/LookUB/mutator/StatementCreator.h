@@ -9,6 +9,8 @@
 #include "scc/program/GlobalVar.h"
 #include "scc/utils/Counter.h"
 
+#include <array>
+
 /// Creates new random statements.
 class StatementCreator : public UnsafeMutatorBase {
   TypeCreator tc;
@@ -27,15 +29,42 @@ class StatementCreator : public UnsafeMutatorBase {
   /// Creates literals for types.
   LiteralMaker literalMaker;
 
+  /// How many makeExpr/makeStmt calls are currently creating code.
+  unsigned creationDepth = 0;
+
+  /// Marks that code is created until the scope is destroyed.
+  struct CreationScope {
+    unsigned &depth;
+    explicit CreationScope(unsigned &depth) : depth(depth) { ++depth; }
+    ~CreationScope() { --depth; }
+  };
+
+  /// Verifies the created code (depending on the verification level and
+  /// how deeply it's nested in other created code).
+  void verifyCreated(const Statement &s) {
+    if (Verification::shouldVerifyCreated(creationDepth))
+      s.verifySelf(p);
+  }
+
   /// Verifies the code/program and returns it.
   template <typename T> T verify(T s) {
-    s.verifySelf(p);
+    verifyCreated(s);
     return s;
   }
 
 public:
   StatementCreator(MutatorData &input);
 
+  /// Prepares this StatementCreator for another mutation of the program.
+  ///
+  /// Recycled statements are dropped as they might reference variables that
+  /// are not in scope in the next mutation.
+  void reset() {
+    stmtStack.clear();
+    tc.reset();
+    snippets.reset();
+  }
+
   /// Queues a statement to be recycled later.
   void pushStmtOnStack(Statement s) { stmtStack.push_back(s); }
 
@@ -85,7 +114,7 @@ public:
     f->isStatic = decision(Frag::FunctionIsStatic);
     if (p.getLangOpts().isCxx())
       f->isNoExcept = decision(Frag::FunctionIsNoExcept);
-    return &p.add(std::move(f));
+    return &addDecl(std::move(f));
   }
 
   /// Creates a function with the given signature (encoded as a function ptr
@@ -120,11 +149,7 @@ public:
 
   /// Returns any function.
   Function *getAnyFunction() {
-    std::vector<Function *> options;
-    for (Decl *d : p.getDeclList()) {
-      if (d->getKind() == Decl::Kind::Function)
-        options.push_back(static_cast<Function *>(d));
-    }
+    const std::vector<Function *> &options = getDeclIndex().getFunctions();
     if (options.empty())
       return createFunctionWithReturnType(tc.getReturnType());
     return getRng().pickOneVec(options);
@@ -136,11 +161,14 @@ public:
     if (!context.function)
       return makeStmt(context);
 
-    auto labels = getAllLabels(*context.function);
-    if (labels.empty())
+    const FlatBody &body = getFlatBody(*context.function);
+    const size_t numLabels = body.count(StmtKind::GotoLabel);
+    if (numLabels == 0)
       return makeStmt(context);
 
-    return Statement::Goto(getRng().pickOneVec(labels).id);
+    const size_t label =
+        body.findNth(StmtKind::GotoLabel, getRng().pickIndex(numLabels));
+    return Statement::Goto(body.getID(label));
   }
 
   /// Creates a random 'throw' statement.
@@ -229,20 +257,14 @@ public:
       else
         g->setInit(makeConstant(c, t));
     }
-    return &p.add(std::move(g));
+    return &addDecl(std::move(g));
   }
 
   /// Returns a global that might already exist.
   GlobalVar *makeOrFindGlobal(TypeRef t) {
-    for (Decl *d : p.getDeclList()) {
-      if (d->getKind() == Decl::Kind::GlobalVar) {
-        GlobalVar *g = static_cast<GlobalVar *>(d);
-        if (g->getAsVar().getType() == t) {
-          if (decision(Frag::PickExistingGlobal))
-            return g;
-        }
-      }
-    }
+    for (GlobalVar *g : getDeclIndex().getGlobalsOfType(t))
+      if (decision(Frag::PickExistingGlobal))
+        return g;
     return makeGlobal(t);
   }
 
@@ -295,14 +317,13 @@ public:
 
   Statement makeDeref(const StatementContext &context, TypeRef t) {
     return Statement::Deref(
-        t, makeExpr(context,
-                    types.getOrCreateDerived(idents, Type::Kind::Pointer, t)));
+        t, makeExpr(context, getOrCreateDerived(Type::Kind::Pointer, t)));
   }
 
   /// Make a subscript statement (that is, a 'array[x]' statement).
   Statement makeSubscript(const StatementContext &context, TypeRef t) {
-    Statement base = makeExpr(
-        context, types.getOrCreateDerived(idents, Type::Kind::Pointer, t));
+    Statement base =
+        makeExpr(context, getOrCreateDerived(Type::Kind::Pointer, t));
     Statement index = makeExpr(context, tc.getAnyIntType(/*allowConst=*/true));
     return Statement::Subscript(t, base, index);
   }
@@ -312,6 +333,15 @@ public:
     // Same type, so fine to convert.
     if (from == to)
       return true;
+    TypeIndex &index = getTypeIndex();
+    if (std::optional<bool> cached = index.getCachedConversion(from, to))
+      return *cached;
+    const bool result = canTypeConvertToImpl(from, to);
+    index.cacheConversion(from, to, result);
+    return result;
+  }
+
+  bool canTypeConvertToImpl(TypeRef from, TypeRef to) {
     const Type &fromT = types.get(from);
     const Type &toT = types.get(to);
 
@@ -328,17 +358,34 @@ public:
   /// Returns a variable reference.
   Statement makeVarRef(const StatementContext &context, TypeRef t) {
     // Check if we can use a variable that is in context.
-    if (decision(Frag::PickLocalVar))
-      for (const auto &v : context.variables)
-        if (canTypeConvertTo(v.second.getType(), t))
-          return Statement::LocalVarRef(v.second);
+    if (decision(Frag::PickLocalVar)) {
+      size_t numOptions = 0;
+      context.forEachVar([&](const Variable &v) {
+        if (canTypeConvertTo(v.getType(), t))
+          ++numOptions;
+      });
+      if (numOptions != 0) {
+        // Pick one of the fitting variables and search it again.
+        size_t toPick = getRng().pickIndex(numOptions);
+        std::optional<Variable> picked;
+        context.forEachVar([&](const Variable &v) {
+          if (picked || !canTypeConvertTo(v.getType(), t))
+            return;
+          if (toPick-- == 0)
+            picked = v;
+        });
+        return Statement::LocalVarRef(*picked);
+      }
+    }
     return Statement::GlobalVarRef(makeOrFindGlobal(t)->getAsVar());
   }
 
-  std::vector<BuiltinFunctions::Kind> callableBuiltins() const;
+  /// Returns a random builtin function that we can call.
+  BuiltinFunctions::Kind pickCallableBuiltin();
 
   /// Creates a random expression evaluating to the given type.
   Statement makeExprImpl(const StatementContext &context, TypeRef t) {
+    AllocStats::Scope allocScope(AllocPhase::Expressions);
     SCCAssert(types.isValid(t), "Expression with invalid type?");
 
     auto verifyScope = p.queueVerify();
@@ -354,14 +401,14 @@ public:
     if (decision(Frag::CallBuiltin)) {
       auto verifyScope = p.queueVerify();
       for (auto counter : count::upTo(10)) {
-        BuiltinFunctions::Kind kind = getRng().pickOneVec(callableBuiltins());
+        BuiltinFunctions::Kind kind = pickCallableBuiltin();
         const TypeRef returnT = builtinFuncs.getReturnType(p, kind);
         if (returnT == t) {
-          Function *f = builtinFuncs.get(p, kind);
+          Function *f = getBuiltinFunc(kind);
           return verify(makeCallToFunc(context, f));
         }
         if (types.get(returnT).isPointer() && isPointer) {
-          Function *f = builtinFuncs.get(p, kind);
+          Function *f = getBuiltinFunc(kind);
           return Statement::Cast(t, verify(makeCallToFunc(context, f)));
         }
       }
@@ -387,16 +434,20 @@ public:
         AddrOf,
         New
       };
-      std::vector<Options> options = {Constant, Subscript, Bin,  Call, Var,
-                                      Var,      Var,       Cast, Deref};
+      // Options that are only valid in some cases are at the end, so the
+      // valid options are always a prefix of the table.
+      static constexpr std::array<Options, 11> options = {
+          Constant, Subscript, Bin,   Call,   Var, Var,
+          Var,      Cast,      Deref, AddrOf, New};
+      size_t numOptions = 9;
       // If this is a pointer, we can also take the address of something.
       if (isPointer) {
-        options.push_back(AddrOf);
+        ++numOptions;
         if (p.getLangOpts().isCxx())
-          options.push_back(New);
+          ++numOptions;
       }
       // Pick one option.
-      switch (getRng().pickOneVec(options)) {
+      switch (options[getRng().pickIndex(numOptions)]) {
       case Constant:
         return verify(makeConstant(context, t));
       case Bin:
@@ -465,8 +516,11 @@ public:
   }
 
   Statement makeExpr(const StatementContext &context, TypeRef t) {
-    Statement s = makeExprImpl(context, t);
-    s.verifySelf(p);
+    Statement s = [&]() {
+      CreationScope scope(creationDepth);
+      return makeExprImpl(context, t);
+    }();
+    verifyCreated(s);
     SCCAssert(s.isExpr(), "makeExpr returned a statement?");
     return s;
   }
@@ -517,47 +571,31 @@ public:
     if (isDefinition) {
       if (getType(t).getKind() == Type::Kind::Array) {
         Statement res = Statement::VarDef(t, id, makeArrayInit(context, t));
-        context.variables[id] = info;
+        context.addVariable(info);
         return res;
       } else {
         Statement res = Statement::VarDef(t, id, makeExpr(context, t));
-        context.variables[id] = info;
+        context.addVariable(info);
         return res;
       }
     }
-    context.variables[id] = info;
+    context.addVariable(info);
     return Statement::VarDecl(t, id);
   }
 
-  struct JumpLabel {
-    NameID id = InvalidName;
-    JumpLabel() = default;
-    explicit JumpLabel(NameID id) : id(id) {}
-  };
-
-  /// Returns all goto labels in the given function.
-  std::vector<JumpLabel> getAllLabels(const Function &f) {
-    std::vector<JumpLabel> res;
-    auto children = f.getBody().getAllChildren();
-    for (const Statement::StmtAndParent &p : children) {
-      if (p.stmt->getKind() == StmtKind::GotoLabel)
-        res.emplace_back(p.stmt->getJumpTarget());
-    }
-    return res;
-  }
-
   std::string makeStmtAttr() {
     return getRng().pickOne({"[[likely]]", "[[unlikely]]"});
   }
 
   Statement makeBuiltinCallStmt(StatementContext &context) {
-    BuiltinFunctions::Kind kind = getRng().pickOneVec(callableBuiltins());
-    Function *f = builtinFuncs.get(p, kind);
+    BuiltinFunctions::Kind kind = pickCallableBuiltin();
+    Function *f = getBuiltinFunc(kind);
     return wrapExprInStmt(makeCallToFunc(context, f));
   }
 
   /// Creates a random statement.
   Statement makeStmtImpl(StatementContext &context, bool avoidDecl = false) {
+    AllocStats::Scope allocScope(AllocPhase::Statements);
     auto verifyScope = p.queueVerify();
 
     // Maybe we can just create a snippet?
@@ -598,21 +636,23 @@ public:
       Label,
       Compound
     };
-    std::vector<Opt> toPick = {Return, Expr,     If,       While,   VarDecl,
-                               Call,   VarDef,   Asm,      Break,   Goto,
-                               Label,  Compound, Compound, Compound};
+    // Language-specific options are at the end, so the valid options are
+    // always a prefix of the table.
+    static constexpr std::array<Opt, 17> toPick = {
+        Return, Expr,     If,       While,    VarDecl, Call,
+        VarDef, Asm,      Break,    Goto,     Label,   Compound,
+        Compound, Compound, Delete, Try,      Throw};
+    size_t numOptions = 14;
     // For C++, we can generate C++ generic statements.
     if (p.getLangOpts().isCxx()) {
-      if (false) { // TODO: This frequently causes miscompiles.
-        toPick.push_back(Try);
-        toPick.push_back(Throw);
-      }
-      toPick.push_back(Delete);
+      ++numOptions; // Delete
+      // TODO: Try/Throw frequently cause miscompiles, so they are never
+      // picked.
     }
 
     // Pick one of the options and branch to one of the specific generation
     // functions.
-    switch (getRng().pickOneVec(toPick)) {
+    switch (toPick[getRng().pickIndex(numOptions)]) {
     case Return:
       return verify(makeReturn(context));
     case Compound:
@@ -660,8 +700,11 @@ public:
 
   /// Creates a random statement.
   Statement makeStmt(StatementContext &context, bool avoidDecl = false) {
-    Statement s = makeStmtImpl(context, avoidDecl);
-    s.verifySelf(p);
+    Statement s = [&]() {
+      CreationScope scope(creationDepth);
+      return makeStmtImpl(context, avoidDecl);
+    }();
+    verifyCreated(s);
     SCCAssert(s.isStmt(), "makeStmt returned expression?");
     return s;
   }
@@ -674,9 +717,9 @@ public:
       if (c.getKind() == StmtKind::Empty)
         break;
       context.expandWithStmt(c);
-      children.push_back(c);
+      children.push_back(std::move(c));
     }
-    return Statement::CompoundStmt(children);
+    return Statement::CompoundStmt(std::move(children));
   }
 
   /// Recreates the statement context for f.
@@ -684,7 +727,7 @@ public:
     StatementContext context(f);
     // Make function args available.
     for (const Variable &arg : f.getArgs()) {
-      context.variables[arg.getName()] = arg;
+      context.addVariable(arg);
       // Don't add argv which has variable contents and makes test cases
       // unstable.
       // FIXME: This actually helped in the past with making interesting test
@@ -709,10 +752,10 @@ public:
     if (decision(Frag::EnsureReturnInFunc))
       children.push_back(makeReturn(context));
 
-    Statement body = Statement::CompoundStmt(children);
-    body.verifySelf(p);
+    Statement body = Statement::CompoundStmt(std::move(children));
+    verifyChange(body);
     if (auto canonicalized = Canonicalizer::canonicalizeStmt(body))
-      body = *canonicalized;
+      body = std::move(*canonicalized);
 
     return body;
   }
@@ -5,6 +5,7 @@
 #include "LiteralMaker.h"
 #include "Simplifier.h"
 #include "StatementCreator.h"
+#include "StmtSampler.h"
 #include "UnsafeMutatorBase.h"
 
 /// Mutates an existing statement in various ways.
@@ -17,6 +18,9 @@ class StatementMutator : public UnsafeMutatorBase {
 public:
   StatementMutator(MutatorData &input);
 
+  /// Prepares this StatementMutator for another mutation of the program.
+  void reset() { sc.reset(); }
+
   /// Mutates a compound statement.
   ///
   /// Returns true iff the given statement was modified.
@@ -27,6 +31,7 @@ public:
 
     // The new child statements.
     std::vector<Statement> children;
+    children.reserve(s.getNumChildren() + 1);
 
     // Choose a random index to insert a new statement.
     size_t index = 0;
@@ -41,7 +46,7 @@ public:
     }
 
     // Form a new compound statement with the generated children.
-    s = Statement::CompoundStmt(children);
+    s = Statement::CompoundStmt(std::move(children));
     return true;
   }
 
@@ -49,9 +54,10 @@ public:
   /// its direct children.
   bool promoteChildren(Statement &s) {
     std::vector<Statement> newChildren;
+    newChildren.reserve(s.getNumChildren());
     for (auto &c : s.getChildren())
       newChildren.push_back(ensureStmt(c));
-    s = Statement::CompoundStmt(newChildren);
+    s = Statement::CompoundStmt(std::move(newChildren));
     return true;
   }
 
@@ -67,8 +73,13 @@ public:
 
   /// Surrounds the statement with random code.
   bool wrapInCompound(StatementContext context, Statement &s) {
-    s = Statement::CompoundStmt(
-        {sc.makeStmt(context), s, sc.makeStmt(context)});
+    // Move the statement into the new compound instead of copying it.
+    std::vector<Statement> children;
+    children.reserve(3);
+    children.push_back(sc.makeStmt(context));
+    children.push_back(std::move(s));
+    children.push_back(sc.makeStmt(context));
+    s = Statement::CompoundStmt(std::move(children));
     return true;
   }
 
@@ -109,7 +120,7 @@ public:
         // if the declared variable is used anywhere, then we can't modify
         // further on the off-chance that we might delete it and render
         // the references to the variable invalid.
-        if (isVarUsed(parent, s))
+        if (isVarUsed(context, parent, s))
           return Modified::No;
       }
 
@@ -135,24 +146,6 @@ public:
     return Modified::Yes;
   }
 
-  /// Returns the reconstructed StatementContext (e.g., what variables are in
-  /// scope for the given statement).
-  std::optional<StatementContext>
-  rebuildStatementContextFor(StatementContext ctx, Statement &base,
-                             Statement &target) {
-    if (base.getKind() == StmtKind::While)
-      ctx.inLoop = true;
-
-    for (Statement &s : base) {
-      if (&s == &target)
-        return ctx;
-      ctx.expandWithStmt(s);
-      if (auto nested = rebuildStatementContextFor(ctx, s, target))
-        return nested;
-    }
-    return ctx;
-  }
-
   /// Mutates a random child of the given statement.
   Modified mutateRandomChild(StatementContext context, Statement &s) {
     // For simplicity, place an empty child in compound statements.
@@ -167,22 +160,27 @@ public:
     if (simplifier.simplifyCompound(s))
       return Modified::Yes;
 
-    // Pick a random child of the given statement.
-    std::vector<Statement::StmtAndParent> allChildren = s.getAllChildren();
-    if (allChildren.empty())
+    // Pick a random child of the given statement. Allocations that aren't
+    // attributed to a more specific phase below are counted for this phase.
+    AllocStats::Scope allocScope(AllocPhase::MutationSites);
+    typedef StmtSampler::Filter Filter;
+    const StmtSampler sampler(s);
+    const size_t numNodes = sampler.getNum(Filter::Any);
+    if (numNodes == 0)
       return Modified::No;
-    Statement::StmtAndParent toModify = getRng().pickOneVec(allChildren);
+    // The sampler also builds a statement context for the picked child so we
+    // know which variables are in scope.
+    StmtSampler::Site toModify =
+        sampler.select(s, context, getRng().pickIndex(numNodes), Filter::Any);
 
     // If we have an expression and we prefer modifying statements, then
-    // try picking another one.
-    while (toModify.stmt->isExpr()) {
-      if (!decision(Frag::PreferModifyingStmtsOverExprs))
-        break;
-      toModify = getRng().pickOneVec(allChildren);
-    }
-
-    // Build a statement context so we know which variables are in scope.
-    context = *rebuildStatementContextFor(context, s, *toModify.stmt);
+    // pick one of the statements instead.
+    const size_t numStmts = sampler.getNum(Filter::Stmts);
+    if (toModify.stmt->isExpr() && numStmts != 0 &&
+        decision(Frag::PreferModifyingStmtsOverExprs))
+      toModify = sampler.select(s, context, getRng().pickIndex(numStmts),
+                                Filter::Stmts);
+    context = toModify.context;
 
     // Try to just simplify the code and see if this helps.
     if (decision(Frag::SimplifyStmt))
@@ -199,14 +197,22 @@ public:
   Modified mutateFunctionBody(Function &f, Statement &newBody) {
     StatementContext context = sc.getContextForFunction(f);
     // Maybe try to just make a new function body.
-    if (decision(Frag::RegenerateFunctionBody))
+    bool regenerated = false;
+    if (decision(Frag::RegenerateFunctionBody)) {
       newBody = sc.makeCompoundStmt(context);
-    // Mutate a random piece of code in the function.
-    if (mutateRandomChild(context, newBody) == Modified::No)
+      // A regenerated body is always kept, so store it right away. Otherwise
+      // the indices (e.g., the uses checked by isVarUsed/canMutate and the
+      // labels for new gotos) would describe the old body.
+      setFunctionBody(f, newBody);
+      regenerated = true;
+    }
+    // Mutate a random piece of code in the function. A regenerated body is
+    // a modification on its own.
+    if (mutateRandomChild(context, newBody) == Modified::No && !regenerated)
       return Modified::No;
     // Clean up any weird artifacts from the mutation process.
     if (auto canonicalized = Canonicalizer::canonicalizeStmt(newBody))
-      newBody = *canonicalized;
+      newBody = std::move(*canonicalized);
     return Modified::Yes;
   }
 };
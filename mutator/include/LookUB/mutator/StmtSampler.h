@@ -0,0 +1,62 @@
+#ifndef STMTSAMPLER_H
+#define STMTSAMPLER_H
+
+#include "StatementContext.h"
+#include "scc/program/Statement.h"
+
+#include <cstddef>
+#include <vector>
+
+/// Picks random nodes from a statement tree.
+///
+/// The sampler counts the nodes, statements and expressions in every subtree
+/// of the tree once. Selecting the n-th statement/expression/node then only
+/// walks down the path to it, and the StatementContext for the selected node
+/// is built along that path.
+///
+/// The root itself is never selected.
+class StmtSampler {
+public:
+  /// Which nodes can be selected.
+  enum class Filter { Any, Stmts, Exprs };
+
+  /// A selected node.
+  struct Site {
+    Statement *stmt = nullptr;
+    Statement *parent = nullptr;
+    /// The context in which 'stmt' is evaluated.
+    StatementContext context;
+  };
+
+  explicit StmtSampler(const Statement &root);
+
+  /// Returns the number of nodes below the root that match the filter.
+  size_t getNum(Filter f) const { return getCount(counts.front(), f); }
+
+  /// Returns the n-th node (in pre-order) below root that matches the filter.
+  /// @param root The root statement this sampler was created for.
+  /// @param context The context of the root statement.
+  Site select(Statement &root, StatementContext context, size_t n,
+              Filter f) const;
+
+private:
+  /// The number of nodes in a subtree (including its root).
+  struct Counts {
+    size_t nodes = 0;
+    size_t stmts = 0;
+    size_t exprs = 0;
+  };
+
+  /// Counts the nodes in the subtree of 's' and returns its index.
+  size_t countSubtree(const Statement &s);
+  /// Returns the number of nodes matching the filter in the given subtree.
+  static size_t getCount(const Counts &c, Filter f);
+  /// Returns true if the given node matches the filter.
+  static bool matches(const Statement &s, Filter f);
+
+  /// The counts of each subtree in pre-order. The root's own node is not
+  /// included in its counts.
+  std::vector<Counts> counts;
+};
+
+#endif // STMTSAMPLER_H
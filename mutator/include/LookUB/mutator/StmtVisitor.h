@@ -0,0 +1,81 @@
+#ifndef STMTVISITOR_H
+#define STMTVISITOR_H
+
+#include "scc/program/Statement.h"
+
+/// Traversals over statement trees.
+///
+/// Unlike Statement::foreachChild/forAllChildren, the callbacks here are
+/// template parameters, so they are inlined into the traversal and their
+/// captures don't need to be stored in a std::function.
+class StmtVisitor {
+public:
+  /// What the traversal should do after visiting a node.
+  enum class Result {
+    /// Visit the children of the node and continue afterwards.
+    Continue,
+    /// Don't visit the children of the node but continue afterwards.
+    SkipChildren,
+    /// Stop the whole traversal.
+    Stop
+  };
+
+  /// Calls 'visitor' with 's' and all its (transitive) children in
+  /// pre-order. 'visitor' returns a Result for each node.
+  /// @return False if the traversal was stopped.
+  template <typename Visitor>
+  static bool visit(const Statement &s, Visitor &&visitor) {
+    switch (visitor(s)) {
+    case Result::Stop:
+      return false;
+    case Result::SkipChildren:
+      return true;
+    case Result::Continue:
+      break;
+    }
+    for (const Statement &child : s)
+      if (!visit(child, visitor))
+        return false;
+    return true;
+  }
+
+  /// Calls 'visitor' with 's' and all its (transitive) children of the given
+  /// kind in pre-order.
+  template <typename Visitor>
+  static void visitKind(const Statement &s, Statement::Kind kind,
+                        Visitor &&visitor) {
+    visit(s, [kind, &visitor](const Statement &node) {
+      if (node.getKind() == kind)
+        visitor(node);
+      return Result::Continue;
+    });
+  }
+
+  /// Returns the first node (in pre-order) in 's' for which 'pred' returns
+  /// true. Returns a nullptr if there is no such node.
+  template <typename Pred>
+  static const Statement *find(const Statement &s, Pred &&pred) {
+    const Statement *result = nullptr;
+    visit(s, [&result, &pred](const Statement &node) {
+      if (!pred(node))
+        return Result::Continue;
+      result = &node;
+      return Result::Stop;
+    });
+    return result;
+  }
+
+  /// Returns true if 'pred' returns true for any node in 's'.
+  template <typename Pred>
+  static bool contains(const Statement &s, Pred &&pred) {
+    return find(s, pred) != nullptr;
+  }
+
+  /// Returns true if 's' contains a node of the given kind.
+  static bool containsKind(const Statement &s, Statement::Kind kind) {
+    return contains(
+        s, [kind](const Statement &node) { return node.getKind() == kind; });
+  }
+};
+
+#endif // STMTVISITOR_H
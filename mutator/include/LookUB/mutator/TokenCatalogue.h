@@ -0,0 +1,44 @@
+#ifndef TOKENCATALOGUE_H
+#define TOKENCATALOGUE_H
+
+#include <string>
+#include <vector>
+
+/// Process-wide, immutable tables of the tokens that the mutator emits.
+///
+/// The tables are built once on first use and then shared by all mutator
+/// components, so creating a component doesn't rebuild them.
+class TokenCatalogue {
+  TokenCatalogue();
+
+public:
+  /// Returns the catalogue of this process.
+  static const TokenCatalogue &get();
+
+  /// Known 'special' integer literals.
+  ///
+  /// Mostly powers of two and neighbors.
+  const std::vector<std::string> &getSpecialIntegers() const {
+    return specialIntegers;
+  }
+  /// Known 'special' float literals.
+  ///
+  /// Mostly powers of two and neighbors.
+  const std::vector<std::string> &getSpecialFloats() const {
+    return specialFloats;
+  }
+  /// Function attributes that don't have any random parameters.
+  const std::vector<std::string> &getFixedFuncAttrs() const {
+    return fixedFuncAttrs;
+  }
+  /// All characters that can appear in an identifier.
+  const std::string &getIdentifierChars() const { return identifierChars; }
+
+private:
+  std::vector<std::string> specialIntegers;
+  std::vector<std::string> specialFloats;
+  std::vector<std::string> fixedFuncAttrs;
+  std::string identifierChars;
+};
+
+#endif // TOKENCATALOGUE_H
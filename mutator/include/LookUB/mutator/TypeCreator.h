@@ -30,6 +30,9 @@ class TypeCreator : UnsafeMutatorBase {
 public:
   TypeCreator(MutatorData &input);
 
+  /// Prepares this TypeCreator for another mutation of the program.
+  void reset() { typesCreated = 0; }
+
   /// Returns a random valid type.
   TypeRef getAnyType() {
     if (decision(Frag::PickVoidForAny))
@@ -39,7 +42,7 @@ public:
 
   /// Returns the pointer type that points to memory of the given type.
   TypeRef getPtrTypeOf(TypeRef t) {
-    return types.getOrCreateDerived(idents, Type::Kind::Pointer, t);
+    return getOrCreateDerived(Type::Kind::Pointer, t);
   }
 
   /// Returns a random pointer type.
@@ -79,20 +82,14 @@ public:
 
   /// Returns an existing type that is defined (e.g., has a size).
   TypeRef getExistingDefinedType() {
-    std::vector<TypeRef> options;
-    for (const Type &t : types)
-      if (!builtin.isVoid(t.getRef()))
-        options.push_back(t.getRef());
-    return options.at(getRng().pickIndex(options.size()));
+    AllocStats::Scope allocScope(AllocPhase::Types);
+    return pickType(TypeIndex::Category::Defined);
   }
 
   /// Returns an existing type that is defined and not an array type.
   TypeRef getExistingNonArrayDefinedType() {
-    std::vector<TypeRef> options;
-    for (const Type &t : types)
-      if (!builtin.isVoid(t.getRef()) && t.getKind() != Type::Kind::Array)
-        options.push_back(t.getRef());
-    return options.at(getRng().pickIndex(options.size()));
+    AllocStats::Scope allocScope(AllocPhase::Types);
+    return pickType(TypeIndex::Category::NonArrayDefined);
   }
 
   /// Creates a new Ptr type.
@@ -109,7 +106,7 @@ public:
     std::vector<TypeRef> args;
     for (unsigned i = 0; i < getRng().getBelow(5U); ++i)
       args.push_back(getExistingDefinedType());
-    return types.addType(
+    return addType(
         Type::FunctionPointer(ret, args, idents.makeNewID("funcPtrT")));
   }
 
@@ -121,7 +118,7 @@ public:
       if (types.get(ret).isArray())
         continue;
       unsigned size = 1U + getRng().getBelow(128U);
-      return types.addType(Type::Array(ret, size, idents.makeNewID("arrayT")));
+      return addType(Type::Array(ret, size, idents.makeNewID("arrayT")));
     }
   }
 
@@ -140,12 +137,10 @@ public:
 
   /// Returns a type that is defined and not const.
   TypeRef getDefinedNonConstType() {
-    while (true) {
-      TypeRef t = getDefinedType();
-      if (types.isConst(t))
-        continue;
+    TypeRef t = getDefinedType();
+    if (!types.isConst(t))
       return t;
-    }
+    return pickType(TypeIndex::Category::NonConstDefined);
   }
 
   /// Returns a type that is complete/defined.
@@ -183,13 +178,13 @@ public:
     r->addField(makeField(expectedMember));
     for (unsigned i = 0; i < getRng().getBelow(fieldLimit); ++i)
       r->addField(makeField());
-    return &p.add(std::move(r));
+    return &addDecl(std::move(r));
   }
 
   /// Returns a random record type.
   TypeRef makeRecordType() {
     Record *r = makeRecord(Void());
-    return r->getType();
+    return noteType(r->getType());
   }
 };
 
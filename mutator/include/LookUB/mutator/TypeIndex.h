@@ -0,0 +1,77 @@
+#ifndef TYPEINDEX_H
+#define TYPEINDEX_H
+
+#include "scc/program/Program.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/// Index of the types in a program, sorted into categories.
+///
+/// Allows picking a random type of some category without scanning the whole
+/// type table. The index is built from the type table once and afterwards
+/// the mutator adds every type it creates. Changes that remove or modify
+/// types (e.g., type garbage collection) need to invalidate the index.
+///
+/// The index also caches which types implicitly convert to each other.
+class TypeIndex {
+public:
+  enum class Category {
+    /// Pointer types.
+    Pointer,
+    /// Types that are complete/defined (everything but void).
+    Defined,
+    /// Defined types that are not arrays.
+    NonArrayDefined,
+    /// Defined types that are not const.
+    NonConstDefined,
+    NumCategories
+  };
+
+  /// Indexes all types in the given table.
+  void build(const TypeTable &types, const BuiltinTypes &builtin);
+  /// Returns true if the index has been built and is still valid.
+  bool isBuilt() const { return built; }
+  /// Forgets all indexed types.
+  void invalidate();
+
+  /// Adds the given type to the index. Does nothing if it's already known
+  /// or if it was deleted (i.e., is invalid).
+  void add(const TypeTable &types, const BuiltinTypes &builtin, TypeRef t);
+
+  /// Returns all types in the given category in type table order.
+  const std::vector<TypeRef> &get(Category c) const {
+    return buckets.at(static_cast<size_t>(c));
+  }
+
+  /// Returns whether 'from' implicitly converts to 'to' if this was cached.
+  std::optional<bool> getCachedConversion(TypeRef from, TypeRef to) const {
+    auto it = conversions.find(conversionKey(from, to));
+    if (it == conversions.end())
+      return {};
+    return it->second;
+  }
+  /// Caches whether 'from' implicitly converts to 'to'.
+  void cacheConversion(TypeRef from, TypeRef to, bool convertible) {
+    conversions[conversionKey(from, to)] = convertible;
+  }
+
+private:
+  static uint64_t conversionKey(TypeRef from, TypeRef to) {
+    return (static_cast<uint64_t>(from.getInternalVal()) << 32U) |
+           static_cast<uint64_t>(to.getInternalVal());
+  }
+
+  bool built = false;
+  std::array<std::vector<TypeRef>, static_cast<size_t>(Category::NumCategories)>
+      buckets;
+  /// Whether the type with the given internal value is indexed.
+  std::vector<bool> known;
+  /// Cached results of implicit conversion checks.
+  std::unordered_map<uint64_t, bool> conversions;
+};
+
+#endif // TYPEINDEX_H
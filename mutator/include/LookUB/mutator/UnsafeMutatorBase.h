@@ -1,23 +1,226 @@
 #ifndef UNSAFEMUTATORBASE_H
 #define UNSAFEMUTATORBASE_H
 
+#include "AllocStats.h"
+#include "DeclIndex.h"
+#include "FlatBody.h"
 #include "StatementContext.h"
+#include "StmtVisitor.h"
+#include "TypeIndex.h"
 #include "UnsafeStrategy.h"
+#include "UseIndex.h"
+#include "Verification.h"
 #include "scc/mutator-utils/MutatorBase.h"
 #include "scc/mutator-utils/Rng.h"
 #include "scc/mutator-utils/StrategyInstance.h"
 #include "scc/program/Statement.h"
 
+#include <algorithm>
+#include <vector>
+
 typedef StrategyInstance<UnsafeStrategy> UnsafeInstance;
 
+/// The state shared by all mutator components during one mutation.
+struct UnsafeMutatorData : MutatorBase<UnsafeStrategy>::MutatorData {
+  UnsafeMutatorData(Program &p, UnsafeInstance &s, RngSource source)
+      : MutatorBase<UnsafeStrategy>::MutatorData(p, s, source) {}
+
+  /// Index of the program's types. Built on first use.
+  TypeIndex typeIndex;
+  /// Index of the program's declarations. Built on first use.
+  DeclIndex declIndex;
+  /// Index of the IDs used in function bodies. Built on first use.
+  UseIndex useIndex;
+  /// The flattened function bodies. Each is built on first use.
+  FlatBodyCache flatBodies;
+  /// The functions and global variables added by the current mutation
+  /// attempt. See UnsafeMutatorBase::beginAttempt.
+  std::vector<Decl *> attemptDecls;
+};
+
 /// Base class for different parts of the 'unsafe' way to mutate programs.
 struct UnsafeMutatorBase : MutatorBase<UnsafeStrategy> {
-  UnsafeMutatorBase(MutatorData &i) : MutatorBase(i) {}
+  typedef UnsafeMutatorData MutatorData;
+
+  UnsafeMutatorBase(MutatorData &i) : MutatorBase(i), data(i) {}
+
+  /// Returns the index of all types in the program.
+  TypeIndex &getTypeIndex() {
+    if (!data.typeIndex.isBuilt())
+      data.typeIndex.build(types, builtin);
+    return data.typeIndex;
+  }
+
+  /// Returns a random existing type from the given category.
+  TypeRef pickType(TypeIndex::Category c) {
+    const std::vector<TypeRef> &options = getTypeIndex().get(c);
+    SCCAssert(!options.empty(), "No type in category?");
+    return options.at(getRng().pickIndex(options.size()));
+  }
+
+  /// Notes that the given type might have been created by the mutator.
+  /// @return The given type.
+  TypeRef noteType(TypeRef t) {
+    if (data.typeIndex.isBuilt())
+      data.typeIndex.add(types, builtin, t);
+    return t;
+  }
+
+  /// Adds the given type to the program.
+  TypeRef addType(Type t) { return noteType(types.addType(std::move(t))); }
+
+  /// Returns the type derived from 'base' with the given kind. The type is
+  /// created if it doesn't exist yet.
+  TypeRef getOrCreateDerived(Type::Kind kind, TypeRef base) {
+    return noteType(types.getOrCreateDerived(idents, kind, base));
+  }
+
+  /// Verifies code that was created or changed by the mutator.
+  void verifyChange(const Statement &s) {
+    if (Verification::shouldVerifyChange())
+      s.verifySelf(p);
+  }
+
+  /// Verifies the program after the given statement in it was changed.
+  ///
+  /// Depending on the verification level this either verifies the whole
+  /// program or just the changed statement.
+  void verifyProgramAfterChange(const Statement &changed) {
+    switch (Verification::getTargetAfterChange()) {
+    case VerifyTarget::Nothing:
+      break;
+    case VerifyTarget::Change:
+      changed.verifySelf(p);
+      break;
+    case VerifyTarget::Program:
+      p.verifySelf();
+      break;
+    }
+  }
+
+  /// Verifies the program after a change that can affect all of it.
+  void verifyProgram() {
+    if (Verification::shouldVerifyChange())
+      p.verifySelf();
+  }
+
+  /// Forgets all indices of the program. Must be called after the program
+  /// was changed behind the back of the indices (e.g., by scc utilities that
+  /// remove declarations).
+  void invalidateIndices() {
+    data.typeIndex.invalidate();
+    data.declIndex.invalidate();
+    data.useIndex.invalidate();
+    data.flatBodies.clear();
+    data.attemptDecls.clear();
+  }
+
+  /// Returns the index of all declarations in the program.
+  DeclIndex &getDeclIndex() {
+    if (!data.declIndex.isBuilt())
+      data.declIndex.build(p);
+    return data.declIndex;
+  }
+
+  /// Notes that the given declaration might have been added to the program.
+  /// @return The given declaration.
+  template <typename T> T *noteDecl(T *d) {
+    if (data.declIndex.isBuilt())
+      data.declIndex.add(p, d);
+    if (data.useIndex.isBuilt() && d->getKind() == Decl::Kind::Function) {
+      const Function *f = static_cast<const Function *>(static_cast<Decl *>(d));
+      data.useIndex.setFunctionBody(f, f->getBody());
+    }
+    return d;
+  }
 
-  /// Returns true if the given var decl is references anywhere in the given
+  /// Adds the given declaration to the program.
+  template <typename T> T &addDecl(std::unique_ptr<T> d) {
+    T &added = *noteDecl(&p.add(std::move(d)));
+    noteAttemptDecl(&added);
+    return added;
+  }
+
+  /// Removes the given declaration from the program.
+  void removeDecl(Decl *d) {
+    auto attemptIt =
+        std::find(data.attemptDecls.begin(), data.attemptDecls.end(), d);
+    if (attemptIt != data.attemptDecls.end())
+      data.attemptDecls.erase(attemptIt);
+    if (data.declIndex.isBuilt())
+      data.declIndex.remove(d);
+    if (d->getKind() == Decl::Kind::Function)
+      data.flatBodies.invalidate(static_cast<Function *>(d));
+    if (data.useIndex.isBuilt() && d->getKind() == Decl::Kind::Function)
+      data.useIndex.removeFunction(static_cast<Function *>(d));
+    p.removeDecl(d);
+  }
+
+  /// Starts a new mutation attempt that can be undone with rollbackAttempt.
+  void beginAttempt() { data.attemptDecls.clear(); }
+
+  /// Removes all functions and global variables that were added since the
+  /// last call to beginAttempt.
+  ///
+  /// Only the declarations are removed. Types, identifiers and builtin
+  /// functions stay in the program (unused types are removed by the type
+  /// garbage collector). The caller has to make sure that the rest of the
+  /// program doesn't reference the removed declarations.
+  void rollbackAttempt() {
+    std::vector<Decl *> added;
+    added.swap(data.attemptDecls);
+    for (auto it = added.rbegin(); it != added.rend(); ++it)
+      removeDecl(*it);
+  }
+
+  /// Returns the index of the IDs used in the program's function bodies.
+  UseIndex &getUseIndex() {
+    if (!data.useIndex.isBuilt())
+      data.useIndex.build(getDeclIndex().getFunctions());
+    return data.useIndex;
+  }
+
+  /// Notes that the body of the given function will be replaced by 'body'.
+  void noteBodyChanged(const Function &f, const Statement &body) {
+    data.flatBodies.invalidate(&f);
+    if (data.useIndex.isBuilt())
+      data.useIndex.setFunctionBody(&f, body);
+  }
+
+  /// Returns the flattened body of the given function.
+  const FlatBody &getFlatBody(const Function &f) {
+    return data.flatBodies.get(f);
+  }
+
+  /// Replaces the body of the given function.
+  void setFunctionBody(Function &f, Statement body) {
+    noteBodyChanged(f, body);
+    f.setBody(std::move(body));
+  }
+
+  /// Remembers declarations that rollbackAttempt has to remove again.
+  void noteAttemptDecl(Decl *d) {
+    // Records are referenced by their types which are never rolled back.
+    if (d->getKind() == Decl::Kind::Function ||
+        d->getKind() == Decl::Kind::GlobalVar)
+      data.attemptDecls.push_back(d);
+  }
+
+  /// Returns the given builtin function. Declares it if necessary.
+  Function *getBuiltinFunc(BuiltinFunctions::Kind kind) {
+    return noteDecl(builtinFuncs.get(p, kind));
+  }
+
+  /// Returns true if the given var decl is referenced anywhere in the given
   /// parent statement.
-  bool isVarUsed(const Statement &parent, const Statement &varDecl) {
-    return parent.forAllChildren([&varDecl](const Statement &other) {
+  bool isVarUsed(const StatementContext &context, const Statement &parent,
+                 const Statement &varDecl) {
+    // Local variables can only be referenced in their function, so checking
+    // the uses in the function is enough.
+    if (context.function)
+      return getUseIndex().getUsesIn(context.function,
+                                     varDecl.getDeclaredVarID()) != 0;
+    return StmtVisitor::contains(parent, [&varDecl](const Statement &other) {
       return other == Stmt::Kind::LocalVarRef &&
              other.getReferencedVarID() == varDecl.getDeclaredVarID();
     });
@@ -36,14 +239,10 @@ struct UnsafeMutatorBase : MutatorBase<UnsafeStrategy> {
         s.getKind() == Statement::Kind::Catch)
       return false;
 
-    if (s.getKind() == Statement::Kind::GotoLabel) {
+    if (s.getKind() == Statement::Kind::GotoLabel && context.function) {
       // For GotoLabels, check all goto's to make sure it is not leaving
       // them without a valid target.
-      if (!context.getFuncBody().forAllChildren([&context](const Statement &s) {
-            if (s.getKind() != Statement::Kind::GotoLabel)
-              return true;
-            return !context.getFuncBody().usesID(s.getJumpTarget());
-          }))
+      if (getUseIndex().getUsesIn(context.function, s.getJumpTarget()) != 0)
         return false;
     }
 
@@ -65,6 +264,10 @@ struct UnsafeMutatorBase : MutatorBase<UnsafeStrategy> {
       return Statement::VarDef(c.getEvalType(), newID(), c);
     return Statement::StmtExpr(c);
   }
+
+protected:
+  /// The state shared with the other components.
+  MutatorData &data;
 };
 
 #endif // UNSAFEMUTATORBASE_H
@@ -0,0 +1,88 @@
+#ifndef USEINDEX_H
+#define USEINDEX_H
+
+#include "scc/program/Function.h"
+#include "scc/program/Statement.h"
+
+#include <unordered_map>
+#include <vector>
+
+/// Counts how often each NameID and type is used in the function bodies of a
+/// program.
+///
+/// Uses of IDs are references to local/global variables, calls to functions
+/// and gotos to labels. Uses of types are the types of all expressions and
+/// declared variables. The counts are kept per function and for the whole
+/// program and are updated a function body at a time, so checking whether
+/// some variable, function, label or type is used doesn't require walking
+/// code.
+///
+/// Only function bodies are indexed. Other places that can refer to IDs
+/// (e.g., global variable initializers) need to be checked separately.
+class UseIndex {
+public:
+  /// Indexes the bodies of all given functions.
+  void build(const std::vector<Function *> &functions);
+  /// Returns true if the index has been built and is still valid.
+  bool isBuilt() const { return built; }
+  /// Forgets all indexed uses.
+  void invalidate();
+
+  /// Updates the index after the body of the given function changed.
+  void setFunctionBody(const Function *f, const Statement &body);
+  /// Removes all uses in the given function from the index.
+  void removeFunction(const Function *f);
+
+  /// Returns how often the given ID is used in all function bodies.
+  unsigned getUses(NameID id) const { return getCount(total, id); }
+  /// Returns how often the given ID is used in the body of the function.
+  unsigned getUsesIn(const Function *f, NameID id) const;
+  /// Returns how often the given type is used in all function bodies.
+  unsigned getTypeUses(TypeRef t) const { return getCount(totalTypes, t); }
+
+private:
+  typedef std::unordered_map<NameID, unsigned> UseCounts;
+  typedef std::unordered_map<TypeRef, unsigned> TypeUseCounts;
+
+  /// The uses in a single function body.
+  struct BodyUses {
+    UseCounts ids;
+    TypeUseCounts types;
+  };
+
+  /// Adds all uses in the given statement to 'uses'.
+  static void countUses(const Statement &s, BodyUses &uses);
+  template <typename Key>
+  static unsigned getCount(const std::unordered_map<Key, unsigned> &counts,
+                           Key key) {
+    auto it = counts.find(key);
+    if (it == counts.end())
+      return 0;
+    return it->second;
+  }
+  /// Adds (or subtracts) the counts in 'from' to 'to'.
+  template <typename Key>
+  static void addCounts(const std::unordered_map<Key, unsigned> &from,
+                        std::unordered_map<Key, unsigned> &to, bool subtract) {
+    for (const auto &use : from) {
+      if (!subtract) {
+        to[use.first] += use.second;
+        continue;
+      }
+      auto it = to.find(use.first);
+      it->second -= use.second;
+      if (it->second == 0)
+        to.erase(it);
+    }
+  }
+
+  bool built = false;
+  /// The uses in the body of each function.
+  std::unordered_map<const Function *, BodyUses> perFunction;
+  /// The sum of all per-function ID uses.
+  UseCounts total;
+  /// The sum of all per-function type uses.
+  TypeUseCounts totalTypes;
+};
+
+#endif // USEINDEX_H
@@ -0,0 +1,108 @@
+#ifndef VERIFICATION_H
+#define VERIFICATION_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// How thoroughly the mutator verifies the code it produces.
+enum class VerifyLevel {
+  /// Never verify.
+  Off,
+  /// Fully verify, but only every VerifySampleRate-th time.
+  Sampled,
+  /// Only verify the code that was created or changed by a mutation. Nested
+  /// code is verified once as part of the outermost created code.
+  Changed,
+  /// Verify every created piece of code and the whole program after every
+  /// change to it.
+  Full,
+};
+
+/// What should be verified after a local change to the program.
+enum class VerifyTarget {
+  /// Nothing.
+  Nothing,
+  /// Only the changed code.
+  Change,
+  /// The whole program.
+  Program,
+};
+
+#ifndef LOOKUB_DEFAULT_VERIFY_LEVEL
+#define LOOKUB_DEFAULT_VERIFY_LEVEL Full
+#endif
+
+/// The process-wide verification setting.
+///
+/// The default is picked at build time via `-DLOOKUB_VERIFY_LEVEL=...` and
+/// can be changed at runtime with `--verify=...`.
+class Verification {
+public:
+  /// In sampled mode, one out of this many checks is done.
+  static constexpr unsigned VerifySampleRate = 64;
+
+  /// Returns the current verification level.
+  static VerifyLevel getLevel() { return level; }
+  /// Changes the verification level.
+  static void setLevel(VerifyLevel l) { level = l; }
+
+  /// Returns the level with the given name (e.g. "changed").
+  static std::optional<VerifyLevel> parseLevel(const std::string &name);
+  /// Returns the user-readable name of the given level.
+  static const char *getLevelName(VerifyLevel l);
+
+  /// Returns true if code created or changed by the mutator should be
+  /// verified.
+  static bool shouldVerifyChange() {
+    switch (level) {
+    case VerifyLevel::Off:
+      return false;
+    case VerifyLevel::Sampled:
+      return takeSample();
+    case VerifyLevel::Changed:
+    case VerifyLevel::Full:
+      return true;
+    }
+    return true;
+  }
+
+  /// Returns true if code created by the mutator should be verified.
+  /// @param depth How many pieces of code that are currently created
+  ///              contain the code, i.e., 0 for the outermost created code.
+  static bool shouldVerifyCreated(unsigned depth) {
+    // The outermost code is verified as a whole, which covers nested code.
+    if (level == VerifyLevel::Changed && depth != 0)
+      return false;
+    return shouldVerifyChange();
+  }
+
+  /// Returns what should be verified after a local change to the program.
+  ///
+  /// In sampled mode this only takes a single sample.
+  static VerifyTarget getTargetAfterChange() {
+    switch (level) {
+    case VerifyLevel::Off:
+      return VerifyTarget::Nothing;
+    case VerifyLevel::Sampled:
+      return takeSample() ? VerifyTarget::Program : VerifyTarget::Nothing;
+    case VerifyLevel::Changed:
+      return VerifyTarget::Change;
+    case VerifyLevel::Full:
+      return VerifyTarget::Program;
+    }
+    return VerifyTarget::Program;
+  }
+
+private:
+  /// Returns true for every VerifySampleRate-th call.
+  ///
+  /// This is counter-based so that verification doesn't consume random
+  /// values and change the produced programs.
+  static bool takeSample() { return ++sampleCounter % VerifySampleRate == 0; }
+
+  static VerifyLevel level;
+  static uint64_t sampleCounter;
+};
+
+#endif // VERIFICATION_H
@@ -0,0 +1,84 @@
+#include "LookUB/mutator/AllocStats.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+struct AtomicCounter {
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> bytes{0};
+};
+
+constexpr size_t numPhases = static_cast<size_t>(AllocPhase::NumPhases);
+std::array<AtomicCounter, numPhases> counters;
+} // namespace
+
+AllocStats::Counter AllocStats::get(AllocPhase phase) {
+  const AtomicCounter &c = counters.at(static_cast<size_t>(phase));
+  Counter result;
+  result.allocations = c.allocations.load(std::memory_order_relaxed);
+  result.bytes = c.bytes.load(std::memory_order_relaxed);
+  return result;
+}
+
+const char *AllocStats::getPhaseName(AllocPhase phase) {
+  switch (phase) {
+#define ALLOC_PHASE(ID)                                                        \
+  case AllocPhase::ID:                                                         \
+    return #ID;
+#include "LookUB/mutator/AllocPhases.def"
+  case AllocPhase::NumPhases:
+    break;
+  }
+  return "INVALID";
+}
+
+#ifdef LOOKUB_ALLOC_STATS
+
+/// The phase that allocations of this thread are attributed to.
+static thread_local AllocPhase currentPhase = AllocPhase::Other;
+
+AllocStats::Scope::Scope(AllocPhase phase) : previous(currentPhase) {
+  currentPhase = phase;
+}
+
+AllocStats::Scope::~Scope() { currentPhase = previous; }
+
+static void *countedAlloc(size_t size) {
+  AtomicCounter &c = counters[static_cast<size_t>(currentPhase)];
+  c.allocations.fetch_add(1, std::memory_order_relaxed);
+  c.bytes.fetch_add(size, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+// Replacements for the global allocation functions. These live in the same
+// file as AllocStats::Scope so they are always linked in with it.
+
+void *operator new(size_t size) {
+  if (void *res = countedAlloc(size))
+    return res;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+  if (void *res = countedAlloc(size))
+    return res;
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return countedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+
+#endif // LOOKUB_ALLOC_STATS
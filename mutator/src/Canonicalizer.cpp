@@ -13,36 +13,59 @@ static bool hasVarDecls(const Statement &s) {
   return false;
 }
 
+/// Copies the children of 's' before 'end' into 'out'. Empty statements
+/// are skipped like in the canonicalized compound.
+static void copyUnchangedPrefix(const Statement &s, size_t end,
+                                std::vector<Statement> &out) {
+  const auto &children = s.getChildren();
+  out.reserve(children.size());
+  for (size_t i = 0; i < end; ++i)
+    if (children[i].getKind() != StmtKind::Empty)
+      out.push_back(children[i]);
+}
+
 std::optional<Statement> Canonicalizer::canonicalize(const Statement &s) {
   const auto &children = s.getChildren();
   switch (s.getKind()) {
   case StmtKind::Compound: {
+    // Nested compounds can only be flattened into this one if that doesn't
+    // change the scope of any variable. This only depends on the children
+    // of 's', so check it once for all children.
+    const bool canFlatten = !hasVarDecls(s);
 
+    // The new children are only materialized once the first child changes.
+    // Until then 's' is left as is and no new tree is allocated.
     bool hasChanges = false;
-
     std::vector<Statement> newChildren;
-    for (const Statement &child : s) {
+    for (size_t i = 0; i < children.size(); ++i) {
+      const Statement &child = children[i];
       if (child.getKind() == StmtKind::Empty)
         continue;
 
-      auto newChild = child;
-      if (auto canonChild = canonicalize(child)) {
-        newChild = *canonChild;
+      std::optional<Statement> canonChild = canonicalize(child);
+      const Statement &newChild = canonChild ? *canonChild : child;
+      const bool flatten =
+          canFlatten && newChild.getKind() == StmtKind::Compound;
+      if (!hasChanges && (canonChild || flatten)) {
         hasChanges = true;
+        copyUnchangedPrefix(s, i, newChildren);
       }
+      if (!hasChanges)
+        continue;
 
-      if (newChild.getKind() == StmtKind::Compound && !hasVarDecls(s)) {
+      if (flatten) {
         for (const Statement &nestedChild : newChild)
           newChildren.push_back(nestedChild);
-        hasChanges = true;
-      } else
-        newChildren.push_back(newChild);
+      } else if (canonChild)
+        newChildren.push_back(std::move(*canonChild));
+      else
+        newChildren.push_back(child);
     }
 
     if (!hasChanges)
       break;
 
-    return Statement::CompoundStmt(newChildren);
+    return Statement::CompoundStmt(std::move(newChildren));
   }
   case StmtKind::If: {
     auto newChild = canonicalize(children.at(1));
@@ -57,18 +80,20 @@ std::optional<Statement> Canonicalizer::canonicalize(const Statement &s) {
     break;
   }
   case StmtKind::Try: {
+    // Try statements are always rebuilt and reported as changed, so an
+    // enclosing compound is always rebuilt too and drops its empty
+    // statements.
     std::vector<Statement> newChildren;
-    for (const Statement &child : s) {
-
-      auto newChild = child;
+    newChildren.reserve(children.size());
+    for (const Statement &child : children) {
       if (auto canonChild = canonicalize(child))
-        newChild = *canonChild;
-
-      newChildren.push_back(newChild);
+        newChildren.push_back(std::move(*canonChild));
+      else
+        newChildren.push_back(child);
     }
-    Statement tryBody = newChildren.front();
+    Statement tryBody = std::move(newChildren.front());
     newChildren.erase(newChildren.begin());
-    return Statement::Try(tryBody, newChildren);
+    return Statement::Try(std::move(tryBody), std::move(newChildren));
   }
   case StmtKind::Catch: {
     auto newChild = canonicalize(children.at(0));
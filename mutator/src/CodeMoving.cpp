@@ -9,17 +9,19 @@ CodeMoving::outlineStatement(const StatementContext &ctx, Statement &s) {
   auto f = std::make_unique<Function>(
       returnT, p.getIdents().makeNewID("outlined"), std::vector<Variable>{});
 
-  Statement newBody = s;
-  if (s.isExpr())
-    newBody = Statement::Return(newBody);
-  f->setBody(newBody);
-
+  // The statement is replaced below, so move it into the new function.
   const bool isStmt = s.isStmt();
+  const bool isExpr = s.isExpr();
+  Statement newBody = std::move(s);
+  if (isExpr)
+    newBody = Statement::Return(std::move(newBody));
+  f->setBody(std::move(newBody));
+
   s = Statement::Call(returnT, f->getNameID(), {});
   if (isStmt)
     s = Statement::StmtExpr(s);
 
-  p.add(std::move(f));
+  addDecl(std::move(f));
 
   return Modified::Yes;
 }
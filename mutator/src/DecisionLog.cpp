@@ -0,0 +1,13 @@
+#include "LookUB/mutator/DecisionLog.h"
+
+void DecisionLog::add(const std::vector<Frag> &decisions) {
+  for (Frag f : decisions)
+    add(f);
+}
+
+bool DecisionLog::empty() const {
+  for (uint32_t count : counts)
+    if (count != 0)
+      return false;
+  return true;
+}
@@ -0,0 +1,68 @@
+#include "LookUB/mutator/DeclIndex.h"
+
+#include <algorithm>
+
+/// Removes the given element from the vector while keeping the order.
+template <typename T> static void eraseValue(std::vector<T> &vec, T value) {
+  vec.erase(std::remove(vec.begin(), vec.end(), value), vec.end());
+}
+
+static size_t typeKey(TypeRef t) { return t.getInternalVal(); }
+
+void DeclIndex::build(const Program &p) {
+  invalidate();
+  for (Decl *d : p.getDeclList())
+    add(p, d);
+  built = true;
+}
+
+void DeclIndex::invalidate() {
+  built = false;
+  all.clear();
+  known.clear();
+  functions.clear();
+  globalsByType.clear();
+  main = nullptr;
+}
+
+void DeclIndex::add(const Program &p, Decl *d) {
+  if (!known.insert(d).second)
+    return;
+  all.push_back(d);
+
+  if (d->getKind() == Decl::Kind::Function) {
+    Function *f = static_cast<Function *>(d);
+    functions.push_back(f);
+    if (f->isMain(p))
+      main = f;
+  } else if (d->getKind() == Decl::Kind::GlobalVar) {
+    GlobalVar *g = static_cast<GlobalVar *>(d);
+    globalsByType[typeKey(g->getAsVar().getType())].push_back(g);
+  }
+}
+
+void DeclIndex::remove(Decl *d) {
+  if (known.erase(d) == 0)
+    return;
+  eraseValue(all, d);
+
+  if (d->getKind() == Decl::Kind::Function) {
+    Function *f = static_cast<Function *>(d);
+    eraseValue(functions, f);
+    if (main == f)
+      main = nullptr;
+  } else if (d->getKind() == Decl::Kind::GlobalVar) {
+    GlobalVar *g = static_cast<GlobalVar *>(d);
+    auto it = globalsByType.find(typeKey(g->getAsVar().getType()));
+    if (it != globalsByType.end())
+      eraseValue(it->second, g);
+  }
+}
+
+const std::vector<GlobalVar *> &DeclIndex::getGlobalsOfType(TypeRef t) const {
+  static const std::vector<GlobalVar *> none;
+  auto it = globalsByType.find(typeKey(t));
+  if (it == globalsByType.end())
+    return none;
+  return it->second;
+}
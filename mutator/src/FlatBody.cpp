@@ -0,0 +1,56 @@
+#include "LookUB/mutator/FlatBody.h"
+
+#include "scc/utils/Error.h"
+
+FlatBody::FlatBody(const Statement &body) { add(body); }
+
+void FlatBody::add(const Statement &s) {
+  for (const Statement &child : s)
+    add(child);
+
+  NameID id = InvalidName;
+  switch (s.getKind()) {
+  case Statement::Kind::VarDecl:
+  case Statement::Kind::VarDef:
+    id = s.getDeclaredVarID();
+    break;
+  case Statement::Kind::LocalVarRef:
+  case Statement::Kind::GlobalVarRef:
+    id = s.getReferencedVarID();
+    break;
+  case Statement::Kind::Goto:
+  case Statement::Kind::GotoLabel:
+    id = s.getJumpTarget();
+    break;
+  case Statement::Kind::Call:
+    id = s.getCalledFuncID();
+    break;
+  default:
+    break;
+  }
+  kinds.push_back(s.getKind());
+  ids.push_back(id);
+}
+
+size_t FlatBody::findNth(Statement::Kind kind, size_t n) const {
+  size_t i = 0;
+  for (; i < kinds.size(); ++i) {
+    if (kinds[i] != kind)
+      continue;
+    if (n == 0)
+      break;
+    --n;
+  }
+  SCCAssert(i < kinds.size(), "Not enough nodes of the given kind?");
+  return i;
+}
+
+const FlatBody &FlatBodyCache::get(const Function &f) {
+  auto it = bodies.find(&f);
+  if (it != bodies.end()) {
+    ++hits;
+    return it->second;
+  }
+  ++misses;
+  return bodies.emplace(&f, FlatBody(f.getBody())).first->second;
+}
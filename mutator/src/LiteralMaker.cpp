@@ -2,48 +2,15 @@
 
 #include "scc/utils/Counter.h"
 
-void LiteralMaker::setupIntegers() {
-  specialIntegers.push_back("0");
-
-  unsigned long specialUInt = 1;
-  for (int i = 0; i <= 64; ++i) {
-    specialIntegers.push_back(std::to_string(specialUInt) + "ULL");
-    specialIntegers.push_back(std::to_string(specialUInt + 1u) + "ULL");
-    specialIntegers.push_back(std::to_string(specialUInt - 1U) + "ULL");
-    specialUInt *= 2;
-  }
-
-  long specialInt = -1;
-  for (int i = 0; i <= 62; ++i) {
-    specialIntegers.push_back("(" + std::to_string(specialInt) + "LL)");
-    specialIntegers.push_back("(" + std::to_string(specialInt + 1) + "LL)");
-    specialIntegers.push_back("(" + std::to_string(specialInt - 1) + "LL)");
-    specialInt *= 2;
-  }
-}
-
-void LiteralMaker::setupFloats() {
-  specialFloats.push_back("0.0");
-  unsigned long specialUInt = 1;
-  for (int i = 0; i <= 64; ++i) {
-    specialFloats.push_back(std::to_string(specialUInt) + ".0");
-    specialFloats.push_back(std::to_string(specialUInt + 1u) + ".0");
-    specialFloats.push_back(std::to_string(specialUInt - 1U) + ".0");
-    specialUInt *= 2;
-  }
-}
-
-LiteralMaker::LiteralMaker(MutatorData &input) : UnsafeMutatorBase(input) {
-  setupIntegers();
-  setupFloats();
-}
+LiteralMaker::LiteralMaker(MutatorData &input)
+    : UnsafeMutatorBase(input), catalogue(TokenCatalogue::get()) {}
 
 Statement LiteralMaker::makeConstant(const StatementContext &, TypeRef t) {
+  AllocStats::Scope allocScope(AllocPhase::Literals);
   auto verify = p.queueVerify();
   if (getType(t).getKind() == Type::Kind::Array) {
     auto verify = p.queueVerify();
-    t = types.getOrCreateDerived(idents, Type::Kind::Pointer,
-                                 getType(t).getBase());
+    t = getOrCreateDerived(Type::Kind::Pointer, getType(t).getBase());
   }
   const std::string str = makeConstantStr(t);
   return Statement::Cast(t, Statement::Constant(str, t));
@@ -55,9 +22,9 @@ std::string LiteralMaker::makeConstantStr(TypeRef tref) {
   SCCAssertNotEqual(tref, builtin.void_type,
                     "Trying to make void str literal?");
   if (builtin.isIntType(tref))
-    return getRng().pickOneVec(specialIntegers);
+    return getRng().pickOneVec(catalogue.getSpecialIntegers());
   if (builtin.isFloatType(tref))
-    return getRng().pickOneVec(specialFloats);
+    return getRng().pickOneVec(catalogue.getSpecialFloats());
 
   Type t = getType(tref);
   if (t.getKind() == Type::Kind::Pointer) {
@@ -0,0 +1,99 @@
+#include "LookUB/mutator/MutatorStats.h"
+
+#include <algorithm>
+#include <iomanip>
+
+uint64_t MutatorStats::DecisionProfile::getRejected() const {
+  uint64_t result = 0;
+  for (const auto &reason : rejections)
+    result += reason.second;
+  return result;
+}
+
+MutatorStats::MutatorStats()
+    : decisionProfiles(UnsafeStrategy::getAllFragments().size()) {}
+
+MutatorStats &MutatorStats::get() {
+  static MutatorStats stats;
+  return stats;
+}
+
+void MutatorStats::recordMutation(const std::string &strategy,
+                                  const std::vector<Frag> &decisions,
+                                  bool modified, Clock::duration time) {
+  ++mutations;
+  mutationTime += time;
+  ++strategyMix[strategy];
+  lastStrategy = strategy;
+
+  lastDecisions.clear();
+  lastDecisions.add(decisions);
+  lastDecisions.forEach([&](Frag f, uint32_t count) {
+    DecisionProfile &profile = decisionProfiles.at(static_cast<size_t>(f));
+    profile.fired += count;
+    // Each call only counts once as a mutation.
+    ++profile.mutations;
+    profile.time += time;
+    if (!modified)
+      ++profile.unmodified;
+  });
+}
+
+void MutatorStats::recordOutcome(bool finding, const std::string &reason,
+                                 double cpuSeconds) {
+  lastDecisions.forEach([&](Frag f, uint32_t) {
+    DecisionProfile &profile = decisionProfiles.at(static_cast<size_t>(f));
+    profile.oracleCPUSeconds += cpuSeconds;
+    if (finding)
+      ++profile.findings;
+    else
+      ++profile.rejections[reason];
+  });
+  // Every program has only one outcome.
+  lastDecisions.clear();
+}
+
+void MutatorStats::printDecisionReport(std::ostream &out) const {
+  std::vector<Frag> frags = UnsafeStrategy::getAllFragments();
+  std::stable_sort(frags.begin(), frags.end(), [this](Frag a, Frag b) {
+    return getProfile(a).time > getProfile(b).time;
+  });
+
+  const UnsafeStrategy strat;
+  out << std::left << std::setw(32) << "Decision" << std::right
+      << std::setw(12) << "Fired" << std::setw(12) << "Mutations"
+      << std::setw(12) << "Time (ms)" << std::setw(12) << "ms/Mutation"
+      << std::setw(12) << "Unmodified" << std::setw(10) << "Findings"
+      << std::setw(10) << "Rejected" << std::setw(14) << "Oracle CPU s"
+      << std::setw(14) << "Finds/CPU-h"
+      << "  Top rejection\n";
+  out << std::fixed << std::setprecision(2);
+  for (Frag f : frags) {
+    const DecisionProfile &profile = getProfile(f);
+    const double timeMs =
+        std::chrono::duration<double, std::milli>(profile.time).count();
+    const double perMutation =
+        profile.mutations ? timeMs / profile.mutations : 0;
+    const double unmodified =
+        profile.mutations ? 100.0 * profile.unmodified / profile.mutations : 0;
+    const double findingsPerCPUHour =
+        profile.oracleCPUSeconds > 0
+            ? profile.findings / (profile.oracleCPUSeconds / 3600)
+            : 0;
+
+    auto topRejection = std::max_element(
+        profile.rejections.begin(), profile.rejections.end(),
+        [](const auto &a, const auto &b) { return a.second < b.second; });
+
+    out << std::left << std::setw(32) << strat.getFragName(f) << std::right
+        << std::setw(12) << profile.fired << std::setw(12)
+        << profile.mutations << std::setw(12) << timeMs << std::setw(12)
+        << perMutation << std::setw(11) << unmodified << "%"
+        << std::setw(10) << profile.findings << std::setw(10)
+        << profile.getRejected() << std::setw(14) << profile.oracleCPUSeconds
+        << std::setw(14) << findingsPerCPUHour << "  "
+        << (topRejection == profile.rejections.end() ? "-"
+                                                      : topRejection->first)
+        << "\n";
+  }
+}
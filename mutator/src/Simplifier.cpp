@@ -9,7 +9,7 @@ bool Simplifier::simplifyStmt(StatementContext context, const Statement &parent,
     return false;
   if (s.getKind() == StmtKind::Compound && decision(Frag::EmptyCompound)) {
     s = Statement::CompoundStmt({});
-    p.verifySelf();
+    verifyProgramAfterChange(s);
     return true;
   }
 
@@ -18,7 +18,7 @@ bool Simplifier::simplifyStmt(StatementContext context, const Statement &parent,
 
   if (s.getEvalType() == Void()) {
     s = Statement::Empty();
-    p.verifySelf();
+    verifyProgramAfterChange(s);
     return true;
   }
   s = literals.makeConstant(context, s.getEvalType());
@@ -37,7 +37,7 @@ bool Simplifier::simplifyCompound(Statement &s) {
     if (cleanChildren.size() == s.getNumChildren())
       return false;
     s = Statement::CompoundStmt(cleanChildren);
-    p.verifySelf();
+    verifyProgramAfterChange(s);
     return true;
   }
   if (!decision(Frag::DeleteCompoundStmts))
@@ -53,6 +53,6 @@ bool Simplifier::simplifyCompound(Statement &s) {
   if (cleanChildren.size() == s.getNumChildren())
     return false;
   s = Statement::CompoundStmt(cleanChildren);
-  p.verifySelf();
+  verifyProgramAfterChange(s);
   return true;
 }
@@ -24,7 +24,7 @@ Statement Snippets::createSnippetImpl(const StatementContext &ctx) {
 
   using BI = BuiltinFunctions::Kind;
   auto getBuiltin = [this](BI b) {
-    Function *f = builtinFuncs.get(p, b);
+    Function *f = getBuiltinFunc(b);
     SCCAssert(f, "Failed to create builtin?");
     return f;
   };
@@ -99,9 +99,9 @@ Statement Snippets::createSnippetImpl(const StatementContext &ctx) {
     for (unsigned i = 0; i < getRng().getBelow(10U); ++i) {
       Stmt assign = Stmt::StmtExpr(Stmt::BinaryOp(
           p, Stmt::Kind::Assign, makeSubscript(), makeSubscript()));
-      children.push_back(assign);
+      children.push_back(std::move(assign));
     }
-    return Compound(children);
+    return Compound(std::move(children));
   }
   case CounterLoop: {
     TypeRef t = tc.getAnyIntType();
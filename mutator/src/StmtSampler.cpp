@@ -0,0 +1,90 @@
+#include "LookUB/mutator/StmtSampler.h"
+
+#include "scc/utils/Error.h"
+
+StmtSampler::StmtSampler(const Statement &root) {
+  countSubtree(root);
+  // The root can't be selected.
+  Counts &rootCounts = counts.front();
+  rootCounts.nodes -= 1;
+  if (root.isStmt())
+    rootCounts.stmts -= 1;
+  if (root.isExpr())
+    rootCounts.exprs -= 1;
+}
+
+size_t StmtSampler::countSubtree(const Statement &s) {
+  const size_t index = counts.size();
+  counts.emplace_back();
+  Counts result;
+  result.nodes = 1;
+  result.stmts = s.isStmt() ? 1 : 0;
+  result.exprs = s.isExpr() ? 1 : 0;
+  for (const Statement &child : s) {
+    const Counts &c = counts[countSubtree(child)];
+    result.nodes += c.nodes;
+    result.stmts += c.stmts;
+    result.exprs += c.exprs;
+  }
+  counts[index] = result;
+  return index;
+}
+
+size_t StmtSampler::getCount(const Counts &c, Filter f) {
+  switch (f) {
+  case Filter::Any:
+    return c.nodes;
+  case Filter::Stmts:
+    return c.stmts;
+  case Filter::Exprs:
+    return c.exprs;
+  }
+  return c.nodes;
+}
+
+bool StmtSampler::matches(const Statement &s, Filter f) {
+  switch (f) {
+  case Filter::Any:
+    return true;
+  case Filter::Stmts:
+    return s.isStmt();
+  case Filter::Exprs:
+    return s.isExpr();
+  }
+  return true;
+}
+
+StmtSampler::Site StmtSampler::select(Statement &root, StatementContext context,
+                                      size_t n, Filter f) const {
+  SCCAssert(n < getNum(f), "Selecting node out of range?");
+  Statement *node = &root;
+  size_t nodeIndex = 0;
+  while (true) {
+    if (node->getKind() == Statement::Kind::While)
+      context.inLoop = true;
+
+    size_t childIndex = nodeIndex + 1;
+    Statement *next = nullptr;
+    for (Statement &child : *node) {
+      const Counts &c = counts[childIndex];
+      const size_t inChild = getCount(c, f);
+      if (n < inChild) {
+        next = &child;
+        break;
+      }
+      n -= inChild;
+      // Code after this child can see its declarations.
+      context.expandWithStmt(child);
+      childIndex += c.nodes;
+    }
+    SCCAssert(next, "Failed to find node in counted subtree?");
+
+    if (matches(*next, f)) {
+      if (n == 0)
+        return Site{next, node, context};
+      --n;
+    }
+    node = next;
+    nodeIndex = childIndex;
+  }
+}
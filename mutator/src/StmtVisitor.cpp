@@ -0,0 +1 @@
+#include "LookUB/mutator/StmtVisitor.h"
@@ -0,0 +1,51 @@
+#include "LookUB/mutator/TokenCatalogue.h"
+#include "LookUB/mutator/AllocStats.h"
+
+TokenCatalogue::TokenCatalogue() {
+  specialIntegers.push_back("0");
+
+  unsigned long specialUInt = 1;
+  for (int i = 0; i <= 64; ++i) {
+    specialIntegers.push_back(std::to_string(specialUInt) + "ULL");
+    specialIntegers.push_back(std::to_string(specialUInt + 1u) + "ULL");
+    specialIntegers.push_back(std::to_string(specialUInt - 1U) + "ULL");
+    specialUInt *= 2;
+  }
+
+  long specialInt = -1;
+  for (int i = 0; i <= 62; ++i) {
+    specialIntegers.push_back("(" + std::to_string(specialInt) + "LL)");
+    specialIntegers.push_back("(" + std::to_string(specialInt + 1) + "LL)");
+    specialIntegers.push_back("(" + std::to_string(specialInt - 1) + "LL)");
+    specialInt *= 2;
+  }
+
+  specialFloats.push_back("0.0");
+  specialUInt = 1;
+  for (int i = 0; i <= 64; ++i) {
+    specialFloats.push_back(std::to_string(specialUInt) + ".0");
+    specialFloats.push_back(std::to_string(specialUInt + 1u) + ".0");
+    specialFloats.push_back(std::to_string(specialUInt - 1U) + ".0");
+    specialUInt *= 2;
+  }
+
+  // Dump of random Clang attributes.
+  fixedFuncAttrs = {"__attribute__((always_inline))",
+                    "__attribute__((const))",
+                    "__attribute__((disable_tail_calls))",
+                    "__attribute__((flatten))",
+                    "__attribute__((malloc))",
+                    "__attribute__((no_builtin))",
+                    "__attribute__((noinline))",
+                    "__attribute__((pure))"};
+
+  identifierChars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                    "abcdefghijklmnopqrstuvwxyz"
+                    "0123456789_";
+}
+
+const TokenCatalogue &TokenCatalogue::get() {
+  AllocStats::Scope allocScope(AllocPhase::Setup);
+  static const TokenCatalogue catalogue;
+  return catalogue;
+}
@@ -3,22 +3,17 @@
 TypeCreator::TypeCreator(MutatorData &input) : UnsafeMutatorBase(input) {}
 
 TypeRef TypeCreator::getPtrType() {
+  AllocStats::Scope allocScope(AllocPhase::Types);
   auto verify = p.queueVerify();
-
-  std::vector<TypeRef> options;
-  for (const Type &t : types)
-    if (t.getKind() == Type::Kind::Pointer)
-      options.push_back(t.getRef());
-  assert(!options.empty());
-  return options.at(getRng().pickIndex(options.size()));
+  return pickType(TypeIndex::Category::Pointer);
 }
 
 TypeRef TypeCreator::getAnyIntType(bool allowConst) {
   TypeRef result = getRng().pickOneVec(builtin.getIntTypes());
   if (!types.isConst(result) && decision(Frag::VolatileInt))
-    result = types.getOrCreateDerived(idents, Type::Kind::Volatile, result);
+    result = getOrCreateDerived(Type::Kind::Volatile, result);
   if (allowConst && !types.isVolatile(result) && decision(Frag::ConstInt))
-    result = types.getOrCreateDerived(idents, Type::Kind::Const, result);
+    result = getOrCreateDerived(Type::Kind::Const, result);
   return result;
 }
 
@@ -27,13 +22,14 @@ TypeRef TypeCreator::makeNewPtrType() {
 
   while (true) {
     TypeRef base = getExistingDefinedType();
-    return types.getOrCreateDerived(idents, Type::Kind::Pointer, base);
+    return getOrCreateDerived(Type::Kind::Pointer, base);
   }
   return getPtrType();
   assert(false);
 }
 
 TypeRef TypeCreator::makeNewType() {
+  AllocStats::Scope allocScope(AllocPhase::Types);
   auto verify = p.queueVerify();
 
   ++typesCreated;
@@ -50,11 +46,11 @@ TypeRef TypeCreator::makeNewType() {
                             // Arrays are more interesting.
                             Array, Array, Array, Array})) {
   case Const:
-    return types.getOrCreateDerived(idents, Type::Kind::Const,
-                                    getExistingNonArrayDefinedType());
+    return getOrCreateDerived(Type::Kind::Const,
+                              getExistingNonArrayDefinedType());
   case Volatile:
-    return types.getOrCreateDerived(idents, Type::Kind::Volatile,
-                                    getExistingNonArrayDefinedType());
+    return getOrCreateDerived(Type::Kind::Volatile,
+                              getExistingNonArrayDefinedType());
   case Pointer:
     return makeNewPtrType();
   case FuncPtr:
@@ -68,6 +64,7 @@ TypeRef TypeCreator::makeNewType() {
 }
 
 TypeRef TypeCreator::getDefinedType() {
+  AllocStats::Scope allocScope(AllocPhase::Types);
   auto verify = p.queueVerify();
 
   bool canCreateTypes = !typeRecursionLimit.scope().reached();
@@ -75,11 +72,5 @@ TypeRef TypeCreator::getDefinedType() {
     if (decision(Frag::CreateNewType))
       return makeNewType();
 
-  std::vector<TypeRef> options;
-  for (const Type &t : types) {
-    if (builtin.isVoid(t.getRef()))
-      continue;
-    options.push_back(t.getRef());
-  }
-  return options.at(getRng().pickIndex(options.size()));
+  return pickType(TypeIndex::Category::Defined);
 }
@@ -0,0 +1,46 @@
+#include "LookUB/mutator/TypeIndex.h"
+
+void TypeIndex::build(const TypeTable &types, const BuiltinTypes &builtin) {
+  invalidate();
+  for (const Type &t : types)
+    add(types, builtin, t.getRef());
+  built = true;
+}
+
+void TypeIndex::invalidate() {
+  built = false;
+  for (std::vector<TypeRef> &bucket : buckets)
+    bucket.clear();
+  known.clear();
+  conversions.clear();
+}
+
+void TypeIndex::add(const TypeTable &types, const BuiltinTypes &builtin,
+                    TypeRef t) {
+  const Type &type = types.get(t);
+  // Deleted types stay in the table as invalid slots.
+  if (type.getKind() == Type::Kind::Invalid)
+    return;
+
+  const size_t id = t.getInternalVal();
+  if (id >= known.size())
+    known.resize(id + 1, false);
+  if (known[id])
+    return;
+  known[id] = true;
+
+  auto addTo = [this, t](Category c) {
+    buckets.at(static_cast<size_t>(c)).push_back(t);
+  };
+
+  if (type.getKind() == Type::Kind::Pointer)
+    addTo(Category::Pointer);
+
+  if (builtin.isVoid(t))
+    return;
+  addTo(Category::Defined);
+  if (type.getKind() != Type::Kind::Array)
+    addTo(Category::NonArrayDefined);
+  if (!types.isConst(t))
+    addTo(Category::NonConstDefined);
+}
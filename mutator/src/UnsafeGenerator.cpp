@@ -2,11 +2,14 @@
 #include "LookUB/mutator/Canonicalizer.h"
 #include "LookUB/mutator/FunctionMutator.h"
 #include "LookUB/mutator/LiteralMaker.h"
+#include "LookUB/mutator/MutatorStats.h"
 #include "LookUB/mutator/Simplifier.h"
 #include "LookUB/mutator/Snippets.h"
 #include "LookUB/mutator/StatementContext.h"
 #include "LookUB/mutator/StatementCreator.h"
 #include "LookUB/mutator/StatementMutator.h"
+#include "LookUB/mutator/StmtVisitor.h"
+#include "LookUB/mutator/TokenCatalogue.h"
 #include "LookUB/mutator/TypeCreator.h"
 #include "LookUB/mutator/UnsafeMutatorBase.h"
 #include "scc/mutator-utils/GeneratorUtils.h"
@@ -37,31 +40,98 @@ struct GeneratorImpl : UnsafeMutatorBase {
       : UnsafeMutatorBase(input), literalMaker(input), fm(input), sm(input),
         sc(input) {}
 
+  /// Prepares all components for another mutation of the program.
+  ///
+  /// This is much cheaper than creating a new GeneratorImpl as all the
+  /// component setup (e.g., the literal tables) is kept.
+  void reset() {
+    sm.reset();
+    sc.reset();
+  }
+
   bool couldBeSafeToRemove(Decl *d) {
-    if (d->getKind() == Decl::Kind::GlobalVar) {
-      NameID varId = static_cast<GlobalVar *>(d)->getNameID();
-      return !p.isIDUsed(varId);
-    } else if (d->getKind() == Decl::Kind::Function) {
-      NameID funcName = static_cast<Function *>(d)->getNameID();
-      return !p.isIDUsed(funcName);
+    NameID id;
+    if (d->getKind() == Decl::Kind::GlobalVar)
+      id = static_cast<GlobalVar *>(d)->getNameID();
+    else if (d->getKind() == Decl::Kind::Function)
+      id = static_cast<Function *>(d)->getNameID();
+    else
+      return false;
+    // Most used decls are used in some function body which is indexed.
+    if (getUseIndex().getUses(id) != 0)
+      return false;
+    // Other uses (e.g., in global initializers) need a full check.
+    return !p.isIDUsed(id);
+  }
+
+  /// Returns all non-builtin types that are neither referenced by another
+  /// type nor used in a function body.
+  ///
+  /// These are the only types that can be unused. They might still be used
+  /// by a declaration (e.g., as the type of a global), so p.isTypeUsed has to
+  /// confirm that they are unused.
+  std::vector<TypeRef> getUnreferencedTypes() {
+    std::vector<bool> referenced;
+    auto markReferenced = [&referenced](TypeRef t) {
+      const size_t id = t.getInternalVal();
+      if (id >= referenced.size())
+        referenced.resize(id + 1, false);
+      referenced[id] = true;
+    };
+    for (const Type &t : types) {
+      switch (t.getKind()) {
+      case Type::Kind::Pointer:
+      case Type::Kind::Array:
+      case Type::Kind::Const:
+      case Type::Kind::Volatile:
+        markReferenced(t.getBase());
+        break;
+      case Type::Kind::FunctionPointer:
+        markReferenced(t.getFuncReturnType());
+        for (TypeRef arg : t.getArgs())
+          markReferenced(arg);
+        break;
+      default:
+        break;
+      }
     }
-    return false;
+
+    const UseIndex &uses = getUseIndex();
+    std::vector<TypeRef> result;
+    for (const Type &t : types) {
+      if (t.getKind() == Type::Kind::Invalid)
+        continue;
+      const TypeRef ref = t.getRef();
+      // Never delete the builtin basic types.
+      if (builtin.isBuiltin(ref))
+        continue;
+      const size_t id = ref.getInternalVal();
+      if (id < referenced.size() && referenced[id])
+        continue;
+      if (uses.getTypeUses(ref) != 0)
+        continue;
+      result.push_back(ref);
+    }
+    return result;
   }
 
+  /// How many unreferenced types deleteType checks for uses in declarations.
+  static constexpr unsigned maxDeleteTypeChecks = 8;
+
   Modified deleteType() {
-    return Modified::No;
     auto verifyScope = p.queueVerify();
-    for (Type &t : types) {
-      // Never delete the builtin basic types.
-      if (builtin.isBuiltin(t.getRef()))
-        continue;
-      if (p.isTypeUsed(t.getRef()))
+    std::vector<TypeRef> candidates = getUnreferencedTypes();
+    for (unsigned i = 0; i < maxDeleteTypeChecks && !candidates.empty(); ++i) {
+      const size_t index = getRng().pickIndex(candidates.size());
+      const TypeRef t = candidates[index];
+      candidates[index] = candidates.back();
+      candidates.pop_back();
+      if (p.isTypeUsed(t))
         continue;
-      assert(t.getKind() != Type::Kind::Basic);
-      if (decision(Frag::DeleteTypes)) {
-        t = Type();
-        return Modified::Yes;
-      }
+      assert(types.get(t).getKind() != Type::Kind::Basic);
+      types.get(t) = Type();
+      data.typeIndex.invalidate();
+      return Modified::Yes;
     }
     return Modified::No;
   }
@@ -84,6 +154,8 @@ struct GeneratorImpl : UnsafeMutatorBase {
     if (t.isArray()) {
       if (other != t.getRef() && decision(Frag::MutateTypeBase)) {
         t.setBase(other);
+        // Conversions between types might have changed.
+        data.typeIndex.invalidate();
         return Modified::Yes;
       }
       if (decision(Frag::MutateTypeArraySize)) {
@@ -102,12 +174,18 @@ struct GeneratorImpl : UnsafeMutatorBase {
   }
 
   Modified mutateFunction(Function &f) {
-    if (decision(Frag::MutateFuncAttrs))
+    Modified result = Modified::No;
+    if (decision(Frag::MutateFuncAttrs)) {
       fm.randomizeFuncAttrs(f);
+      result = Modified::Yes;
+    }
 
+    // If the body mutation fails, the partially mutated copy is dropped and
+    // the attempt is rolled back by mutate().
     Statement newBody = f.getBody();
-    sm.mutateFunctionBody(f, newBody);
-    f.setBody(newBody);
+    if (sm.mutateFunctionBody(f, newBody) == Modified::No)
+      return result;
+    setFunctionBody(f, std::move(newBody));
     return Modified::Yes;
   }
 
@@ -126,9 +204,7 @@ struct GeneratorImpl : UnsafeMutatorBase {
     NameID maxID = idents.getLastID();
     const unsigned tries = 100;
     const size_t maxLen = 64;
-    const std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                              "abcdefghijklmnopqrstuvwxyz"
-                              "0123456789_";
+    const std::string &chars = TokenCatalogue::get().getIdentifierChars();
     for (unsigned i = 0; i < tries; ++i) {
       NameID id =
           NameID::fromInternalValue(getRng().getBelow(maxID.getInternalVal()));
@@ -174,7 +250,7 @@ struct GeneratorImpl : UnsafeMutatorBase {
 
   Modified mutateStep() {
     auto verifyScope = p.queueVerify();
-    std::vector<Decl *> d = p.getDeclList();
+    const std::vector<Decl *> &d = getDeclIndex().getAll();
     Decl &toMod = *getRng().pickOneVec(d);
 
     if (decision(Frag::MutateOverDelete) || isMain(toMod)) {
@@ -200,10 +276,11 @@ struct GeneratorImpl : UnsafeMutatorBase {
       if (original.isNamed()) {
         Decl &other = *original.clone();
         NamedDecl &named = static_cast<NamedDecl &>(other);
-        p.removeDecl(&original);
+        removeDecl(&original);
         auto storages = p.getDeclStorages();
         DeclStorage &target = *getRng().pickOneVec(storages);
         target.store(&named, getRng().getBelow(target.size()));
+        noteDecl(&named);
         return Modified::Yes;
       }
     }
@@ -214,55 +291,68 @@ struct GeneratorImpl : UnsafeMutatorBase {
       return mutateType();
 
     else if (couldBeSafeToRemove(&toMod)) {
-      p.removeDecl(&toMod);
+      removeDecl(&toMod);
       return Modified::Yes;
     }
     return Modified::No;
   }
 
   void fixMainReturn() {
-    std::vector<Decl *> decls = p.getDeclList();
-
-    for (Decl *d : decls) {
-      if (isMain(*d)) {
-        Function &main = static_cast<Function &>(*d);
-        bool hasReturn = false;
-
-        main.getBody().foreachChild([&hasReturn](const Statement &child) {
-          hasReturn |= (child == Stmt::Kind::Return);
-          return LoopCtrl::Continue;
-        });
-
-        if (hasReturn)
-          break;
-        StatementContext context = sc.getContextForFunction(main);
-        Stmt returnVal = sc.makeExpr(context, main.getReturnType());
-        Stmt newBody =
-            Stmt::CompoundStmt({main.getBody(), Stmt::Return(returnVal)});
-
-        if (auto canonicalized = Canonicalizer::canonicalizeStmt(newBody))
-          newBody = *canonicalized;
-        main.setBody(newBody);
-        break;
-      }
-    }
+    Function *mainPtr = getDeclIndex().getMain();
+    if (!mainPtr)
+      return;
+    Function &main = *mainPtr;
+    if (StmtVisitor::containsKind(main.getBody(), Stmt::Kind::Return))
+      return;
+    StatementContext context = sc.getContextForFunction(main);
+    Stmt returnVal = sc.makeExpr(context, main.getReturnType());
+    Stmt newBody =
+        Stmt::CompoundStmt({main.getBody(), Stmt::Return(returnVal)});
+
+    if (auto canonicalized = Canonicalizer::canonicalizeStmt(newBody))
+      newBody = std::move(*canonicalized);
+    setFunctionBody(main, newBody);
   }
 
-  void mutate() {
+  /// Mutates the program.
+  /// @return Whether one of the mutation steps modified the program.
+  Modified mutate() {
     auto verifyScope = p.queueVerify();
-    for (unsigned i = 0; i < 200; ++i)
-      if (mutateStep() == Modified::Yes)
+    Modified result = Modified::No;
+    for (unsigned i = 0; i < 200; ++i) {
+      // Each step is a transaction. A failed step might have declared
+      // functions or globals for code that was dropped in the end, so
+      // remove them again instead of leaving unused code in the program.
+      beginAttempt();
+      result = mutateStep();
+      if (result == Modified::Yes)
         break;
+      rollbackAttempt();
+    }
+    beginAttempt();
     if (decision(Frag::FixMainReturn))
       fixMainReturn();
     if (decision(Frag::GarbageCollectTypes)) {
-      TypeGarbageCollector c(p);
-      c.run();
-      p.verifySelf();
+      // Every chain of unused types starts with a type that isn't referenced
+      // anywhere, so the (expensive) collection can be skipped without one.
+      const bool hasCandidates = !getUnreferencedTypes().empty();
+      MutatorStats::get().recordTypeCollection(hasCandidates);
+      if (hasCandidates) {
+        TypeGarbageCollector c(p);
+        c.run();
+        // The collector removed types and possibly the records defining
+        // them, so all indices (which are kept for the next iteration) are
+        // outdated.
+        invalidateIndices();
+        verifyProgram();
+      }
     }
+    return result;
   }
 
   auto getTakenDecisions() const { return strategy.getTakenDecisions(); }
+
+  const FlatBodyCache &getFlatBodies() const { return data.flatBodies; }
 };
 } // namespace
 
@@ -279,20 +369,33 @@ std::vector<UnsafeGenerator::Strategy::Frag>
 UnsafeGenerator::mutate(Program &p, RngSource source, const Strategy &strat,
                         unsigned scaleMul) {
   assert(scaleMul && "Can't be 0 or the fuzzer would do nothing");
+  const auto start = MutatorStats::Clock::now();
   StrategyInstance s(source, strat);
   UnsafeMutatorBase::MutatorData input(p, s, source);
 
-  if (s.decision(UnsafeStrategy::Frag::RegenerateProgram))
+  bool modified = false;
+  if (s.decision(UnsafeStrategy::Frag::RegenerateProgram)) {
     p = *generate(source, p.getLangOpts());
+    modified = true;
+  }
 
-  std::vector<UnsafeGenerator::Strategy::Frag> decisions;
+  // The components are created once and reused for every iteration. They
+  // read the current RNG from 'input', so they see the child RNG below.
+  GeneratorImpl impl(input);
   for (unsigned i = 0; i < strat.scale * scaleMul; ++i) {
-    GeneratorImpl impl(input);
+    impl.reset();
     input.rng = input.rng.spawnChild();
-    impl.mutate();
-    auto n = impl.getTakenDecisions();
-    decisions.insert(decisions.end(), n.begin(), n.end());
+    if (impl.mutate() == UnsafeMutatorBase::Modified::Yes)
+      modified = true;
   }
+  // The strategy instance accumulates the decisions of all iterations, so
+  // they only need to be fetched once.
+  std::vector<UnsafeGenerator::Strategy::Frag> decisions =
+      impl.getTakenDecisions();
+  MutatorStats::get().recordMutation(strat.name, decisions, modified,
+                                     MutatorStats::Clock::now() - start);
+  MutatorStats::get().recordFlatBodyCache(impl.getFlatBodies().getHits(),
+                                          impl.getFlatBodies().getMisses());
   return decisions;
 }
 
@@ -0,0 +1,67 @@
+#include "LookUB/mutator/UseIndex.h"
+#include "LookUB/mutator/StmtVisitor.h"
+
+void UseIndex::build(const std::vector<Function *> &functions) {
+  invalidate();
+  for (const Function *f : functions)
+    setFunctionBody(f, f->getBody());
+  built = true;
+}
+
+void UseIndex::invalidate() {
+  built = false;
+  perFunction.clear();
+  total.clear();
+  totalTypes.clear();
+}
+
+void UseIndex::setFunctionBody(const Function *f, const Statement &body) {
+  removeFunction(f);
+  BodyUses &uses = perFunction[f];
+  countUses(body, uses);
+  addCounts(uses.ids, total, /*subtract=*/false);
+  addCounts(uses.types, totalTypes, /*subtract=*/false);
+}
+
+void UseIndex::removeFunction(const Function *f) {
+  auto it = perFunction.find(f);
+  if (it == perFunction.end())
+    return;
+  addCounts(it->second.ids, total, /*subtract=*/true);
+  addCounts(it->second.types, totalTypes, /*subtract=*/true);
+  perFunction.erase(it);
+}
+
+unsigned UseIndex::getUsesIn(const Function *f, NameID id) const {
+  auto it = perFunction.find(f);
+  if (it == perFunction.end())
+    return 0;
+  return getCount(it->second.ids, id);
+}
+
+void UseIndex::countUses(const Statement &s, BodyUses &uses) {
+  StmtVisitor::visit(s, [&uses](const Statement &child) {
+    UseCounts &counts = uses.ids;
+    switch (child.getKind()) {
+    case Statement::Kind::LocalVarRef:
+    case Statement::Kind::GlobalVarRef:
+      ++counts[child.getReferencedVarID()];
+      break;
+    case Statement::Kind::Goto:
+      ++counts[child.getJumpTarget()];
+      break;
+    case Statement::Kind::Call:
+      ++counts[child.getCalledFuncID()];
+      break;
+    case Statement::Kind::VarDecl:
+    case Statement::Kind::VarDef:
+      ++uses.types[child.getVariableType()];
+      break;
+    default:
+      break;
+    }
+    if (child.isExpr())
+      ++uses.types[child.getEvalType()];
+    return StmtVisitor::Result::Continue;
+  });
+}
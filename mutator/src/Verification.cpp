@@ -0,0 +1,26 @@
+#include "LookUB/mutator/Verification.h"
+
+VerifyLevel Verification::level = VerifyLevel::LOOKUB_DEFAULT_VERIFY_LEVEL;
+uint64_t Verification::sampleCounter = 0;
+
+std::optional<VerifyLevel> Verification::parseLevel(const std::string &name) {
+  for (VerifyLevel l : {VerifyLevel::Off, VerifyLevel::Sampled,
+                        VerifyLevel::Changed, VerifyLevel::Full})
+    if (name == getLevelName(l))
+      return l;
+  return {};
+}
+
+const char *Verification::getLevelName(VerifyLevel l) {
+  switch (l) {
+  case VerifyLevel::Off:
+    return "off";
+  case VerifyLevel::Sampled:
+    return "sampled";
+  case VerifyLevel::Changed:
+    return "changed";
+  case VerifyLevel::Full:
+    return "full";
+  }
+  return "INVALID";
+}
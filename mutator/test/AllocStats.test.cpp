@@ -0,0 +1,38 @@
+#include "LookUB/mutator/AllocStats.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <string>
+
+TEST(TestAllocStats, PhaseNames) {
+  EXPECT_STREQ(AllocStats::getPhaseName(AllocPhase::Literals), "Literals");
+  EXPECT_STREQ(AllocStats::getPhaseName(AllocPhase::NumPhases), "INVALID");
+}
+
+TEST(TestAllocStats, CountsAllocationsInScope) {
+  if (!AllocStats::isEnabled())
+    GTEST_SKIP() << "Configure with -DLOOKUB_ALLOC_STATS=ON to count.";
+
+  const AllocStats::Counter before = AllocStats::get(AllocPhase::Types);
+  const AllocStats::Counter otherBefore =
+      AllocStats::get(AllocPhase::Canonicalization);
+  {
+    AllocStats::Scope scope(AllocPhase::Types);
+    auto p = std::make_unique<char[]>(100);
+    {
+      // Nested scopes take precedence.
+      AllocStats::Scope nested(AllocPhase::Canonicalization);
+      auto q = std::make_unique<int>(1);
+    }
+    // ...and restore the outer phase afterwards.
+    auto r = std::make_unique<char[]>(28);
+  }
+  const AllocStats::Counter after = AllocStats::get(AllocPhase::Types);
+  EXPECT_EQ(after.allocations - before.allocations, 2U);
+  EXPECT_EQ(after.bytes - before.bytes, 128U);
+
+  const AllocStats::Counter otherAfter =
+      AllocStats::get(AllocPhase::Canonicalization);
+  EXPECT_EQ(otherAfter.allocations - otherBefore.allocations, 1U);
+}
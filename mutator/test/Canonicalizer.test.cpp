@@ -12,3 +12,61 @@ TEST(TestCanonicalizer, SimplifyCompound) {
   ASSERT_EQ(res->getChildren().size(), 1U);
   ASSERT_EQ(res->getChildren().front().getKind(), Statement::Kind::Break);
 }
+
+TEST(TestCanonicalizer, KeepCanonicalCode) {
+  // Code that is already canonical is reported as unchanged.
+  auto c = Statement::CompoundStmt({Statement::Break(), Statement::Break()});
+  EXPECT_FALSE(Canonicalizer::canonicalizeStmt(c));
+
+  Program p;
+  Statement cond = Statement::Constant("1", p.getBuiltin().signed_int);
+  auto loop =
+      Statement::While(cond, Statement::CompoundStmt({Statement::Break()}));
+  EXPECT_FALSE(Canonicalizer::canonicalizeStmt(loop));
+}
+
+TEST(TestCanonicalizer, SimplifyOnlyChangedChildren) {
+  // Only the nested compound is flattened, the rest keeps its order.
+  auto c = Statement::CompoundStmt(
+      {Statement::Break(),
+       Statement::CompoundStmt({Statement::VoidReturn(), Statement::Break()}),
+       Statement::Empty(), Statement::VoidReturn()});
+  std::optional<Statement> res = Canonicalizer::canonicalizeStmt(c);
+  ASSERT_TRUE(res);
+
+  const auto &children = res->getChildren();
+  ASSERT_EQ(children.size(), 4U);
+  EXPECT_EQ(children.at(0).getKind(), Statement::Kind::Break);
+  EXPECT_EQ(children.at(1).getKind(), Statement::Kind::VoidReturn);
+  EXPECT_EQ(children.at(2).getKind(), Statement::Kind::Break);
+  EXPECT_EQ(children.at(3).getKind(), Statement::Kind::VoidReturn);
+}
+
+TEST(TestCanonicalizer, KeepScopesWithVariables) {
+  // Compounds are not flattened into a compound that declares variables.
+  Program p;
+  auto c = Statement::CompoundStmt(
+      {Statement::VarDecl(p.getBuiltin().signed_int,
+                          p.getIdents().makeNewID("v")),
+       Statement::CompoundStmt({Statement::Break()})});
+  EXPECT_FALSE(Canonicalizer::canonicalizeStmt(c));
+}
+
+TEST(TestCanonicalizer, RebuildTry) {
+  // Try statements are always rebuilt, so empty statements next to them are
+  // removed even if nothing else changed.
+  Program p;
+  auto handler = Statement::Catch(p.getBuiltin().signed_int,
+                                  p.getIdents().makeNewID("e"),
+                                  Statement::CompoundStmt({}));
+  auto c = Statement::CompoundStmt(
+      {Statement::Empty(),
+       Statement::Try(Statement::CompoundStmt({Statement::Break()}),
+                      {handler})});
+  std::optional<Statement> res = Canonicalizer::canonicalizeStmt(c);
+  ASSERT_TRUE(res);
+
+  const auto &children = res->getChildren();
+  ASSERT_EQ(children.size(), 1U);
+  EXPECT_EQ(children.at(0).getKind(), Statement::Kind::Try);
+}
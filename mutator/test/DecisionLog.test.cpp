@@ -0,0 +1,23 @@
+#include "LookUB/mutator/DecisionLog.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDecisionLog, CountsDecisions) {
+  typedef UnsafeStrategy::Frag Frag;
+  EXPECT_EQ(DecisionLog::NumFrags, UnsafeStrategy::getAllFragments().size());
+
+  DecisionLog log;
+  EXPECT_TRUE(log.empty());
+  log.add({Frag::UseSnippet, Frag::MutateFunction, Frag::UseSnippet});
+  EXPECT_FALSE(log.empty());
+  EXPECT_EQ(log.getCount(Frag::UseSnippet), 2U);
+  EXPECT_EQ(log.getCount(Frag::MutateFunction), 1U);
+  EXPECT_FALSE(log.contains(Frag::RegenerateProgram));
+
+  unsigned visited = 0;
+  log.forEach([&visited](Frag, uint32_t) { ++visited; });
+  EXPECT_EQ(visited, 2U);
+
+  log.clear();
+  EXPECT_TRUE(log.empty());
+}
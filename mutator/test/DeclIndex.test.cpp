@@ -0,0 +1,33 @@
+#include "LookUB/mutator/DeclIndex.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDeclIndex, BuildAndUpdate) {
+  Program p;
+  GeneratorUtils::addMain(p);
+
+  DeclIndex index;
+  EXPECT_FALSE(index.isBuilt());
+  index.build(p);
+  EXPECT_TRUE(index.isBuilt());
+  EXPECT_EQ(index.getAll().size(), p.getDeclList().size());
+  ASSERT_NE(index.getMain(), nullptr);
+  EXPECT_TRUE(index.getMain()->isMain(p));
+
+  const TypeRef t = p.getBuiltin().signed_int;
+  EXPECT_TRUE(index.getGlobalsOfType(t).empty());
+  GlobalVar &g =
+      p.add(std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("g")));
+  // Adding a known decl twice only indexes it once.
+  index.add(p, &g);
+  index.add(p, &g);
+  ASSERT_EQ(index.getGlobalsOfType(t).size(), 1U);
+  EXPECT_EQ(index.getGlobalsOfType(t).front(), &g);
+  EXPECT_EQ(index.getAll().size(), p.getDeclList().size());
+
+  index.remove(&g);
+  p.removeDecl(&g);
+  EXPECT_TRUE(index.getGlobalsOfType(t).empty());
+  EXPECT_EQ(index.getAll().size(), p.getDeclList().size());
+}
@@ -0,0 +1,43 @@
+#include "LookUB/mutator/FlatBody.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestFlatBody, PostOrder) {
+  Program p;
+  const NameID lbl = p.getIdents().makeNewID("lbl");
+  auto body = Statement::CompoundStmt(
+      {Statement::GotoLabel(lbl),
+       Statement::CompoundStmt({Statement::Goto(lbl), Statement::Break()})});
+  FlatBody flat(body);
+
+  ASSERT_EQ(flat.size(), 5U);
+  // Children come before their parents.
+  EXPECT_EQ(flat.getKind(0), Statement::Kind::GotoLabel);
+  EXPECT_EQ(flat.getKind(1), Statement::Kind::Goto);
+  EXPECT_EQ(flat.getKind(2), Statement::Kind::Break);
+  EXPECT_EQ(flat.getKind(3), Statement::Kind::Compound);
+  EXPECT_EQ(flat.getKind(4), Statement::Kind::Compound);
+
+  EXPECT_EQ(flat.count(Statement::Kind::Compound), 2U);
+  EXPECT_EQ(flat.count(Statement::Kind::Return), 0U);
+  EXPECT_EQ(flat.findNth(Statement::Kind::Compound, 1), 4U);
+  EXPECT_EQ(flat.getID(flat.findNth(Statement::Kind::GotoLabel, 0)), lbl);
+}
+
+TEST(TestFlatBody, Cache) {
+  Program p;
+  Function f(p.getBuiltin().signed_int, p.getIdents().makeNewID("f"), {});
+  f.setBody(Statement::CompoundStmt({Statement::Break()}));
+
+  FlatBodyCache cache;
+  EXPECT_EQ(cache.get(f).size(), 2U);
+  EXPECT_EQ(cache.get(f).size(), 2U);
+  EXPECT_EQ(cache.getMisses(), 1U);
+  EXPECT_EQ(cache.getHits(), 1U);
+
+  // Invalidating the body flattens the new body on the next use.
+  f.setBody(Statement::CompoundStmt({}));
+  cache.invalidate(&f);
+  EXPECT_EQ(cache.get(f).size(), 1U);
+  EXPECT_EQ(cache.getMisses(), 2U);
+}
@@ -0,0 +1,51 @@
+#include "LookUB/mutator/MutatorStats.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+TEST(TestMutatorStats, RecordMutation) {
+  MutatorStats stats;
+  stats.recordMutation("test strategy", {}, true,
+                       std::chrono::milliseconds(3));
+  stats.recordMutation("test strategy", {}, true,
+                       std::chrono::milliseconds(2));
+
+  EXPECT_EQ(stats.getMutations(), 2U);
+  EXPECT_EQ(stats.getMutationTime(), std::chrono::milliseconds(5));
+  EXPECT_EQ(stats.getStrategyMix().at("test strategy"), 2U);
+}
+
+TEST(TestMutatorStats, DecisionProfile) {
+  typedef UnsafeStrategy::Frag Frag;
+  MutatorStats stats;
+
+  // The same decision taken twice only counts as one mutation.
+  stats.recordMutation("s", {Frag::MutateFunction, Frag::MutateFunction},
+                       false, std::chrono::milliseconds(4));
+  stats.recordOutcome(/*finding=*/false, "timeout");
+  stats.recordMutation("s", {Frag::MutateFunction, Frag::UseSnippet}, true,
+                       std::chrono::milliseconds(1));
+  stats.recordOutcome(/*finding=*/true, "", /*cpuSeconds=*/2.5);
+  // Outcomes without a mutation are not attributed to anything.
+  stats.recordOutcome(/*finding=*/false, "timeout");
+
+  const auto &mutateFunc = stats.getProfile(Frag::MutateFunction);
+  EXPECT_EQ(mutateFunc.fired, 3U);
+  EXPECT_EQ(mutateFunc.mutations, 2U);
+  EXPECT_EQ(mutateFunc.time, std::chrono::milliseconds(5));
+  EXPECT_EQ(mutateFunc.unmodified, 1U);
+  EXPECT_EQ(mutateFunc.findings, 1U);
+  EXPECT_EQ(mutateFunc.getRejected(), 1U);
+  EXPECT_EQ(mutateFunc.rejections.at("timeout"), 1U);
+  EXPECT_DOUBLE_EQ(mutateFunc.oracleCPUSeconds, 2.5);
+
+  const auto &snippet = stats.getProfile(Frag::UseSnippet);
+  EXPECT_EQ(snippet.mutations, 1U);
+  EXPECT_EQ(snippet.unmodified, 0U);
+  EXPECT_EQ(snippet.getRejected(), 0U);
+
+  std::stringstream report;
+  stats.printDecisionReport(report);
+  EXPECT_NE(report.str().find("MutateFunction"), std::string::npos);
+}
@@ -0,0 +1,27 @@
+#include "LookUB/mutator/StatementContext.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestStatementContext, Variables) {
+  Program p;
+  const Variable a(p.getBuiltin().signed_int, p.getIdents().makeNewID("a"));
+  const Variable b(p.getBuiltin().signed_int, p.getIdents().makeNewID("b"));
+
+  StatementContext outer = StatementContext::Global();
+  outer.addVariable(a);
+
+  // Copies share the outer variables but not the ones added afterwards.
+  StatementContext inner = outer;
+  inner.addVariable(b);
+
+  EXPECT_EQ(outer.getNumVars(), 1U);
+  EXPECT_EQ(inner.getNumVars(), 2U);
+  EXPECT_TRUE(outer.getVar(a.getName()).has_value());
+  EXPECT_FALSE(outer.getVar(b.getName()).has_value());
+  ASSERT_TRUE(inner.getVar(b.getName()).has_value());
+  EXPECT_EQ(inner.getVar(b.getName())->getName(), b.getName());
+
+  unsigned visited = 0;
+  inner.forEachVar([&visited](const Variable &) { ++visited; });
+  EXPECT_EQ(visited, 2U);
+}
@@ -0,0 +1,58 @@
+#include "LookUB/mutator/StatementMutator.h"
+#include "LookUB/mutator/StmtVisitor.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <unordered_set>
+
+/// Returns true if the body references a local variable or label that isn't
+/// declared in it.
+static bool hasDanglingRefs(const Statement &body) {
+  std::unordered_set<NameID> declared;
+  StmtVisitor::visit(body, [&declared](const Statement &s) {
+    if (s == Statement::Kind::VarDecl || s == Statement::Kind::VarDef)
+      declared.insert(s.getDeclaredVarID());
+    if (s == Statement::Kind::GotoLabel)
+      declared.insert(s.getJumpTarget());
+    return StmtVisitor::Result::Continue;
+  });
+  return StmtVisitor::contains(body, [&declared](const Statement &s) {
+    if (s == Statement::Kind::LocalVarRef)
+      return declared.count(s.getReferencedVarID()) == 0;
+    if (s == Statement::Kind::Goto)
+      return declared.count(s.getJumpTarget()) == 0;
+    return false;
+  });
+}
+
+/// Mutates freshly regenerated function bodies. Variables and labels that
+/// are used in the regenerated body must not be removed by the mutation.
+TEST(TestStatementMutator, MutateRegeneratedBody) {
+  typedef UnsafeStrategy::Frag Frag;
+  UnsafeStrategy strat;
+  strat.set(Frag::RegenerateFunctionBody, 1);
+  strat.set(Frag::MutateFoundStatement, 1);
+  strat.set(Frag::SimplifyStmt, 0);
+
+  for (unsigned seed = 0; seed < 200; ++seed) {
+    Program p;
+    GeneratorUtils::addMain(p);
+    // A function without arguments, so all variables are declared in the
+    // body.
+    Function &f = p.add(std::make_unique<Function>(
+        p.getBuiltin().signed_int, p.getIdents().makeNewID("f"),
+        std::vector<Variable>{}));
+    f.setBody(Statement::CompoundStmt({}));
+
+    RngSource source(seed);
+    UnsafeInstance instance(source, strat);
+    UnsafeMutatorData data(p, instance, source);
+    StatementMutator sm(data);
+
+    Statement body = f.getBody();
+    if (sm.mutateFunctionBody(f, body) == UnsafeMutatorBase::Modified::No)
+      continue;
+    EXPECT_FALSE(hasDanglingRefs(body)) << "seed " << seed;
+  }
+}
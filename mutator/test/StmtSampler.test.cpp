@@ -0,0 +1,39 @@
+#include "LookUB/mutator/StmtSampler.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestStmtSampler, CountsAndSelects) {
+  Program p;
+  const TypeRef intT = p.getBuiltin().signed_int;
+  const Variable a(intT, p.getIdents().makeNewID("a"));
+  const Variable b(intT, p.getIdents().makeNewID("b"));
+
+  Statement root = Statement::CompoundStmt(
+      {Statement::VarDecl(a.getType(), a.getName()),
+       Statement::CompoundStmt({Statement::Empty()}),
+       Statement::VarDef(b.getType(), b.getName(),
+                         Statement::LocalVarRef(a))});
+  StmtSampler sampler(root);
+
+  // The VarDecl, the inner compound, its child and the VarDef.
+  EXPECT_EQ(sampler.getNum(StmtSampler::Filter::Stmts), 4U);
+  // The initializer of 'b'.
+  EXPECT_EQ(sampler.getNum(StmtSampler::Filter::Exprs), 1U);
+
+  // Select the inner empty statement.
+  StmtSampler::Site site = sampler.select(root, StatementContext::Global(), 2,
+                                          StmtSampler::Filter::Stmts);
+  EXPECT_EQ(site.stmt->getKind(), Statement::Kind::Empty);
+  EXPECT_EQ(site.parent->getKind(), Statement::Kind::Compound);
+  EXPECT_NE(site.parent, &root);
+  EXPECT_TRUE(site.context.getVar(a.getName()).has_value());
+  EXPECT_FALSE(site.context.getVar(b.getName()).has_value());
+
+  // The only expression is the reference to 'a' in the last statement.
+  site = sampler.select(root, StatementContext::Global(), 0,
+                        StmtSampler::Filter::Exprs);
+  EXPECT_EQ(site.stmt->getKind(), Statement::Kind::LocalVarRef);
+  EXPECT_EQ(site.parent->getKind(), Statement::Kind::VarDef);
+  // 'b' is not in scope within its own initializer.
+  EXPECT_FALSE(site.context.getVar(b.getName()).has_value());
+}
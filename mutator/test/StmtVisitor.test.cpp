@@ -0,0 +1,61 @@
+#include "LookUB/mutator/StmtVisitor.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestStmtVisitor, VisitInPreOrder) {
+  auto s = Statement::CompoundStmt(
+      {Statement::Break(), Statement::CompoundStmt({Statement::VoidReturn()}),
+       Statement::Break()});
+
+  std::vector<Statement::Kind> visited;
+  EXPECT_TRUE(StmtVisitor::visit(s, [&visited](const Statement &node) {
+    visited.push_back(node.getKind());
+    return StmtVisitor::Result::Continue;
+  }));
+  const std::vector<Statement::Kind> expected = {
+      Statement::Kind::Compound, Statement::Kind::Break,
+      Statement::Kind::Compound, Statement::Kind::VoidReturn,
+      Statement::Kind::Break};
+  EXPECT_EQ(visited, expected);
+
+  unsigned breaks = 0;
+  StmtVisitor::visitKind(s, Statement::Kind::Break,
+                         [&breaks](const Statement &) { ++breaks; });
+  EXPECT_EQ(breaks, 2U);
+}
+
+TEST(TestStmtVisitor, EarlyExit) {
+  auto s = Statement::CompoundStmt(
+      {Statement::CompoundStmt({Statement::VoidReturn()}), Statement::Break(),
+       Statement::Break()});
+
+  // Skipping the children of the nested compound hides the return.
+  unsigned visited = 0;
+  StmtVisitor::visit(s, [&visited, &s](const Statement &node) {
+    ++visited;
+    if (&node != &s && node.getKind() == Statement::Kind::Compound)
+      return StmtVisitor::Result::SkipChildren;
+    return StmtVisitor::Result::Continue;
+  });
+  EXPECT_EQ(visited, 4U);
+
+  // Stopping at the first break doesn't visit the second one.
+  visited = 0;
+  EXPECT_FALSE(StmtVisitor::visit(s, [&visited](const Statement &node) {
+    ++visited;
+    if (node.getKind() == Statement::Kind::Break)
+      return StmtVisitor::Result::Stop;
+    return StmtVisitor::Result::Continue;
+  }));
+  EXPECT_EQ(visited, 4U);
+
+  EXPECT_TRUE(StmtVisitor::containsKind(s, Statement::Kind::VoidReturn));
+  EXPECT_FALSE(StmtVisitor::containsKind(s, Statement::Kind::Goto));
+  const Statement *found = StmtVisitor::find(s, [](const Statement &node) {
+    return node.getKind() == Statement::Kind::Break;
+  });
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found, &s.getChildren().at(1));
+}
@@ -0,0 +1,20 @@
+#include "LookUB/mutator/TokenCatalogue.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+TEST(TestTokenCatalogue, SpecialLiterals) {
+  const TokenCatalogue &c = TokenCatalogue::get();
+  // The catalogue is shared.
+  EXPECT_EQ(&c, &TokenCatalogue::get());
+
+  auto contains = [](const std::vector<std::string> &v, std::string s) {
+    return std::find(v.begin(), v.end(), s) != v.end();
+  };
+  EXPECT_TRUE(contains(c.getSpecialIntegers(), "0"));
+  EXPECT_TRUE(contains(c.getSpecialIntegers(), "65ULL"));
+  EXPECT_TRUE(contains(c.getSpecialIntegers(), "(-4611686018427387904LL)"));
+  EXPECT_TRUE(contains(c.getSpecialFloats(), "1024.0"));
+  EXPECT_TRUE(contains(c.getFixedFuncAttrs(), "__attribute__((pure))"));
+}
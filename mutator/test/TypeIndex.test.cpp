@@ -0,0 +1,64 @@
+#include "LookUB/mutator/TypeIndex.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+TEST(TestTypeIndex, MatchesTypeTable) {
+  Program p;
+  const BuiltinTypes &builtin = p.getBuiltin();
+  TypeTable &types = p.getTypes();
+
+  TypeIndex index;
+  EXPECT_FALSE(index.isBuilt());
+  index.build(types, builtin);
+  EXPECT_TRUE(index.isBuilt());
+
+  size_t defined = 0;
+  size_t pointers = 0;
+  for (const Type &t : types) {
+    if (!builtin.isVoid(t.getRef()))
+      ++defined;
+    if (t.getKind() == Type::Kind::Pointer)
+      ++pointers;
+  }
+  EXPECT_EQ(index.get(TypeIndex::Category::Defined).size(), defined);
+  EXPECT_EQ(index.get(TypeIndex::Category::Pointer).size(), pointers);
+
+  index.invalidate();
+  EXPECT_FALSE(index.isBuilt());
+  EXPECT_TRUE(index.get(TypeIndex::Category::Defined).empty());
+}
+
+TEST(TestTypeIndex, AddType) {
+  Program p;
+  TypeIndex index;
+  index.build(p.getTypes(), p.getBuiltin());
+
+  TypeRef t = p.getBuiltin().signed_int;
+  for (unsigned i = 0; i < 3; ++i)
+    t = p.getTypes().getOrCreateDerived(p.getIdents(), Type::Kind::Pointer, t);
+  // Adding the same type twice only indexes it once.
+  index.add(p.getTypes(), p.getBuiltin(), t);
+  index.add(p.getTypes(), p.getBuiltin(), t);
+
+  const auto &ptrs = index.get(TypeIndex::Category::Pointer);
+  EXPECT_EQ(std::count(ptrs.begin(), ptrs.end(), t), 1);
+}
+
+TEST(TestTypeIndex, SkipDeletedTypes) {
+  Program p;
+  TypeRef t = p.getTypes().getOrCreateDerived(
+      p.getIdents(), Type::Kind::Pointer, p.getBuiltin().signed_int);
+  // Deleted types are replaced by invalid types in the table.
+  p.getTypes().get(t) = Type();
+
+  TypeIndex index;
+  index.build(p.getTypes(), p.getBuiltin());
+  for (auto c : {TypeIndex::Category::Pointer, TypeIndex::Category::Defined,
+                 TypeIndex::Category::NonArrayDefined,
+                 TypeIndex::Category::NonConstDefined}) {
+    const auto &bucket = index.get(c);
+    EXPECT_EQ(std::count(bucket.begin(), bucket.end(), t), 0);
+  }
+}
@@ -1,8 +1,14 @@
 #include "LookUB/mutator/UnsafeGenerator.h"
+#include "LookUB/mutator/DeclIndex.h"
+#include "LookUB/mutator/MutatorStats.h"
+#include "LookUB/mutator/TypeIndex.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
 #include "scc/mutator-utils/Scheduler.h"
+#include "scc/program/GlobalVar.h"
 #include "scc/utils/Counter.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <regex>
 
 /// Generates two programs from the same entrophy inputs.
@@ -92,6 +98,98 @@ TEST(TestUnsafeGenerator, generateAndReduce) {
   EXPECT_LT(minNodes * reducedFactor, maxNodes);
 }
 
+typedef UnsafeStrategy::Frag Frag;
+
+/// Returns a strategy that only takes the given decisions.
+static UnsafeStrategy makeOnlyStrat(std::initializer_list<Frag> frags) {
+  UnsafeStrategy strat("test");
+  for (float &v : strat.getValueVecRef())
+    v = 0;
+  for (Frag f : frags)
+    strat.set(f, 1);
+  return strat;
+}
+
+/// Adds the type 'int***' to the program.
+static TypeRef addPointerType(Program &p) {
+  TypeRef t = p.getBuiltin().signed_int;
+  for (unsigned i = 0; i < 3; ++i)
+    t = p.getTypes().getOrCreateDerived(p.getIdents(), Type::Kind::Pointer, t);
+  return t;
+}
+
+/// A type that is only used by the declaration of a global is not deleted.
+TEST(TestUnsafeGenerator, keepTypeOfGlobal) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  TypeRef t = addPointerType(p);
+  p.add(std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("global")));
+
+  UnsafeGenerator gen;
+  UnsafeStrategy strat = makeOnlyStrat({Frag::DeleteTypes});
+  for (unsigned seed = 0; seed < 20; ++seed)
+    gen.mutate(p, RngSource(seed), strat, 1);
+  EXPECT_EQ(p.getTypes().get(t).getKind(), Type::Kind::Pointer);
+}
+
+/// A pointer type that isn't used anywhere is deleted and can't be picked
+/// afterwards.
+TEST(TestUnsafeGenerator, deleteUnusedType) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  TypeRef t = addPointerType(p);
+  // Types are only deleted when a declaration other than main is picked.
+  p.add(std::make_unique<GlobalVar>(p.getBuiltin().signed_int,
+                                    p.getIdents().makeNewID("global")));
+
+  UnsafeGenerator gen;
+  UnsafeStrategy strat = makeOnlyStrat({Frag::DeleteTypes});
+  // Each mutation deletes one unused type.
+  for (unsigned seed = 0; seed < 20; ++seed) {
+    if (p.getTypes().get(t).getKind() == Type::Kind::Invalid)
+      break;
+    gen.mutate(p, RngSource(seed), strat, 1);
+  }
+  ASSERT_EQ(p.getTypes().get(t).getKind(), Type::Kind::Invalid);
+
+  TypeIndex index;
+  index.build(p.getTypes(), p.getBuiltin());
+  const auto &defined = index.get(TypeIndex::Category::Defined);
+  EXPECT_EQ(std::count(defined.begin(), defined.end(), t), 0);
+}
+
+/// The type garbage collector only runs if some type might be unused.
+TEST(TestUnsafeGenerator, skipTypeCollection) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  DeclIndex decls;
+  decls.build(p);
+  // Use every type in main, so no type can be unused.
+  std::vector<Statement> body;
+  for (const Type &t : p.getTypes()) {
+    if (t.getKind() == Type::Kind::Invalid ||
+        p.getBuiltin().isBuiltin(t.getRef()))
+      continue;
+    body.push_back(
+        Statement::VarDecl(t.getRef(), p.getIdents().makeNewID("var")));
+  }
+  decls.getMain()->setBody(Statement::CompoundStmt(body));
+
+  MutatorStats &stats = MutatorStats::get();
+  const uint64_t runs = stats.getTypeCollections();
+  const uint64_t skipped = stats.getSkippedTypeCollections();
+  UnsafeGenerator gen;
+  UnsafeStrategy strat = makeOnlyStrat({Frag::GarbageCollectTypes});
+  gen.mutate(p, RngSource(1), strat, 1);
+  EXPECT_EQ(stats.getTypeCollections(), runs);
+  EXPECT_GT(stats.getSkippedTypeCollections(), skipped);
+
+  // An unused type makes the collector run.
+  addPointerType(p);
+  gen.mutate(p, RngSource(2), strat, 1);
+  EXPECT_GT(stats.getTypeCollections(), runs);
+}
+
 /// How many iterations the test schedulers should make before giving up and
 /// failing a test.
 static const unsigned maxItersToFind = 20000;
@@ -0,0 +1,74 @@
+#include "LookUB/mutator/UnsafeMutatorBase.h"
+#include "scc/mutator-utils/GeneratorUtils.h"
+#include "scc/program/GlobalVar.h"
+
+#include "gtest/gtest.h"
+
+/// Adds a global variable and a function that uses it.
+/// @return The ID of the global variable.
+static NameID addGlobalAndUser(UnsafeMutatorBase &base, Program &p) {
+  const TypeRef t = p.getBuiltin().signed_int;
+  GlobalVar &g = base.addDecl(
+      std::make_unique<GlobalVar>(t, p.getIdents().makeNewID("global")));
+  Function &f = base.addDecl(std::make_unique<Function>(
+      t, p.getIdents().makeNewID("f"), std::vector<Variable>{}));
+  base.setFunctionBody(
+      f, Statement::CompoundStmt({Statement::GlobalVarRef(g.getAsVar())}));
+  return g.getNameID();
+}
+
+TEST(TestUnsafeMutatorBase, RollbackFailedAttempt) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  UnsafeStrategy strat;
+  RngSource source(1);
+  UnsafeInstance instance(source, strat);
+  UnsafeMutatorData data(p, instance, source);
+  UnsafeMutatorBase base(data);
+
+  const size_t decls = base.getDeclIndex().getAll().size();
+  const size_t functions = base.getDeclIndex().getFunctions().size();
+  // Build the use index before the attempt, so it has to be kept up to date.
+  base.getUseIndex();
+
+  base.beginAttempt();
+  const NameID global = addGlobalAndUser(base, p);
+  ASSERT_EQ(base.getDeclIndex().getAll().size(), decls + 2);
+  ASSERT_EQ(base.getUseIndex().getUses(global), 1U);
+
+  // The attempt failed, so everything it added is removed again.
+  base.rollbackAttempt();
+  EXPECT_EQ(base.getDeclIndex().getAll().size(), decls);
+  EXPECT_EQ(base.getDeclIndex().getFunctions().size(), functions);
+  EXPECT_EQ(base.getUseIndex().getUses(global), 0U);
+
+  // The declarations are also gone from the program itself.
+  DeclIndex fresh;
+  fresh.build(p);
+  EXPECT_EQ(fresh.getAll().size(), decls);
+}
+
+TEST(TestUnsafeMutatorBase, KeepSuccessfulAttempt) {
+  Program p;
+  GeneratorUtils::addMain(p);
+  UnsafeStrategy strat;
+  RngSource source(1);
+  UnsafeInstance instance(source, strat);
+  UnsafeMutatorData data(p, instance, source);
+  UnsafeMutatorBase base(data);
+
+  const size_t decls = base.getDeclIndex().getAll().size();
+  base.beginAttempt();
+  const NameID global = addGlobalAndUser(base, p);
+
+  // Like in mutate(), a successful attempt is followed by a new attempt.
+  // Rolling that one back must not remove the previous declarations.
+  base.beginAttempt();
+  base.rollbackAttempt();
+  EXPECT_EQ(base.getDeclIndex().getAll().size(), decls + 2);
+  EXPECT_EQ(base.getUseIndex().getUses(global), 1U);
+
+  DeclIndex fresh;
+  fresh.build(p);
+  EXPECT_EQ(fresh.getAll().size(), decls + 2);
+}
@@ -0,0 +1,50 @@
+#include "LookUB/mutator/UseIndex.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestUseIndex, CountsUses) {
+  Program p;
+  const NameID lbl = p.getIdents().makeNewID("lbl");
+  const NameID unused = p.getIdents().makeNewID("unused");
+  Function f(p.getBuiltin().signed_int, p.getIdents().makeNewID("f"), {});
+  Function g(p.getBuiltin().signed_int, p.getIdents().makeNewID("g"), {});
+  f.setBody(Statement::CompoundStmt(
+      {Statement::Goto(lbl), Statement::Goto(lbl), Statement::GotoLabel(lbl)}));
+  g.setBody(Statement::CompoundStmt({Statement::GotoLabel(unused)}));
+
+  UseIndex index;
+  EXPECT_FALSE(index.isBuilt());
+  index.build({&f, &g});
+  EXPECT_TRUE(index.isBuilt());
+
+  // The label itself is not a use.
+  EXPECT_EQ(index.getUses(lbl), 2U);
+  EXPECT_EQ(index.getUsesIn(&f, lbl), 2U);
+  EXPECT_EQ(index.getUsesIn(&g, lbl), 0U);
+  EXPECT_EQ(index.getUses(unused), 0U);
+
+  // Updating a body replaces its uses.
+  Statement newBody = Statement::CompoundStmt(
+      {Statement::Goto(lbl), Statement::GotoLabel(lbl)});
+  index.setFunctionBody(&f, newBody);
+  EXPECT_EQ(index.getUses(lbl), 1U);
+
+  index.removeFunction(&f);
+  EXPECT_EQ(index.getUses(lbl), 0U);
+}
+
+TEST(TestUseIndex, CountsTypeUses) {
+  Program p;
+  const TypeRef t = p.getBuiltin().unsigned_int;
+  Function f(p.getBuiltin().signed_int, p.getIdents().makeNewID("f"), {});
+  f.setBody(Statement::CompoundStmt(
+      {Statement::VarDecl(t, p.getIdents().makeNewID("a")),
+       Statement::VarDecl(t, p.getIdents().makeNewID("b"))}));
+
+  UseIndex index;
+  index.build({&f});
+  EXPECT_EQ(index.getTypeUses(t), 2U);
+
+  index.setFunctionBody(&f, Statement::CompoundStmt({}));
+  EXPECT_EQ(index.getTypeUses(t), 0U);
+}
@@ -0,0 +1,50 @@
+#include "LookUB/mutator/Verification.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestVerification, ParseLevel) {
+  EXPECT_EQ(Verification::parseLevel("off"), VerifyLevel::Off);
+  EXPECT_EQ(Verification::parseLevel("sampled"), VerifyLevel::Sampled);
+  EXPECT_EQ(Verification::parseLevel("changed"), VerifyLevel::Changed);
+  EXPECT_EQ(Verification::parseLevel("full"), VerifyLevel::Full);
+  EXPECT_FALSE(Verification::parseLevel("everything").has_value());
+}
+
+TEST(TestVerification, Levels) {
+  const VerifyLevel before = Verification::getLevel();
+
+  Verification::setLevel(VerifyLevel::Off);
+  EXPECT_FALSE(Verification::shouldVerifyChange());
+  EXPECT_EQ(Verification::getTargetAfterChange(), VerifyTarget::Nothing);
+
+  Verification::setLevel(VerifyLevel::Changed);
+  EXPECT_TRUE(Verification::shouldVerifyChange());
+  // Only the outermost created code is verified.
+  EXPECT_TRUE(Verification::shouldVerifyCreated(0));
+  EXPECT_FALSE(Verification::shouldVerifyCreated(1));
+  EXPECT_EQ(Verification::getTargetAfterChange(), VerifyTarget::Change);
+
+  Verification::setLevel(VerifyLevel::Full);
+  EXPECT_TRUE(Verification::shouldVerifyChange());
+  EXPECT_TRUE(Verification::shouldVerifyCreated(0));
+  EXPECT_TRUE(Verification::shouldVerifyCreated(1));
+  EXPECT_EQ(Verification::getTargetAfterChange(), VerifyTarget::Program);
+
+  // Sampling verifies exactly one out of VerifySampleRate checks.
+  Verification::setLevel(VerifyLevel::Sampled);
+  unsigned verified = 0;
+  for (unsigned i = 0; i < Verification::VerifySampleRate * 4; ++i)
+    if (Verification::shouldVerifyChange())
+      ++verified;
+  EXPECT_EQ(verified, 4U);
+
+  // A change only takes a single sample, so the program is verified after
+  // exactly one out of VerifySampleRate changes.
+  verified = 0;
+  for (unsigned i = 0; i < Verification::VerifySampleRate * 4; ++i)
+    if (Verification::getTargetAfterChange() == VerifyTarget::Program)
+      ++verified;
+  EXPECT_EQ(verified, 4U);
+
+  Verification::setLevel(before);
+}